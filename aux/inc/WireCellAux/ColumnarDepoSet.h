@@ -0,0 +1,47 @@
+/** An IDepoSet which holds its depos as columns.
+
+    No IDepo objects are made unless depos() is called.  Then one
+    light weight view is made for every row in a single block which
+    shares ownership of the columns.  A view's prior() is the view of
+    its prior row.
+ */
+#ifndef WIRECELLAUX_COLUMNARDEPOSET
+#define WIRECELLAUX_COLUMNARDEPOSET
+
+#include "WireCellIface/IDepoSet.h"
+
+#include <memory>
+#include <mutex>
+
+namespace WireCell::Aux {
+
+    class ColumnarDepoSet : public IDepoSet {
+       public:
+        ColumnarDepoSet(int ident, DepoColumns columns);
+        virtual ~ColumnarDepoSet();
+
+        virtual int ident() const { return m_ident; }
+        virtual IDepo::shared_vector depos() const;
+        virtual const DepoColumns* columns() const;
+
+        // Internal storage of columns and views.
+        struct Table;
+
+       private:
+        int m_ident;
+        std::shared_ptr<Table> m_table;
+        mutable std::once_flag m_once;
+        mutable IDepo::shared_vector m_depos;
+    };
+
+    /// Append the depo as a new row with the given prior row and
+    /// return the new row index.  The row is not made active.
+    size_t append(DepoColumns& cols, const IDepo& depo, int prior = -1);
+
+    /// Append all rows of src to dst, shifting prior indices.  The
+    /// src rows are not made active.  Return the row of the first.
+    size_t append(DepoColumns& dst, const DepoColumns& src);
+
+}  // namespace WireCell::Aux
+
+#endif
@@ -5,6 +5,7 @@
 #define WIRECELLAUX_DEPOTOOLS
 
 #include "WireCellIface/IDepo.h"
+#include "WireCellIface/IDepoSet.h"
 #include "WireCellIface/IAnodePlane.h"
 
 #include "WireCellUtil/Array.h"
@@ -42,6 +43,12 @@ namespace WireCell::Aux {
     IDepo::vector sensitive(const IDepo::vector& depos, IAnodeFace::pointer face);
     IDepo::vector sensitive(const IDepo::vector& depos, IAnodePlane::pointer anode);
 
+    /** As above but taking a depo set.  If the set has columns they
+     * are scanned directly and only the selected depos are taken
+     * from depos().
+     */
+    IDepo::vector sensitive(IDepoSet::pointer deposet, IAnodeFace::pointer face);
+
 }
 
 #endif
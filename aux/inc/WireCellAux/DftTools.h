@@ -67,9 +67,9 @@ namespace WireCell::Aux::DftTools {
     complex_array_t fwd(const IDFT::pointer& dft, const complex_array_t& cwave, int axis);
 
     // Perform forward DFT, returning a complex spectrum given a real
-    // waveform.  The spectrum will have Hermitian symmetry along the
-    // axis of transform but only up to round-off errors accrued
-    // during the transform.
+    // waveform.  The IDFT r2c methods provide the half spectrum up
+    // to the Nyquist frequency and the rest is filled to have exact
+    // Hermitian symmetry along the axis of transform.
     complex_vector_t fwd_r2c(const IDFT::pointer& dft, const real_vector_t& wave);
     complex_array_t fwd_r2c(const IDFT::pointer& dft, const real_array_t& wave, int axis);
 
@@ -80,9 +80,9 @@ namespace WireCell::Aux::DftTools {
     complex_array_t inv(const IDFT::pointer& dft, const complex_array_t& spec, int axis);
 
     // Perform inverse or reverse DFT, returning a real waveform given
-    // a complex spectrum.  Prior to the DFT, the spectrum is forced
-    // to have Hermitian symmetry and thus any input values above the
-    // Nyquist frequency are ignored.
+    // a complex spectrum.  The IDFT c2r methods assume Hermitian
+    // symmetry and thus any input values above the Nyquist frequency
+    // are ignored.
     real_vector_t inv_c2r(const IDFT::pointer& dft, const complex_vector_t& spec);
     real_array_t inv_c2r(const IDFT::pointer& dft, const complex_array_t& spec, int axis);
 
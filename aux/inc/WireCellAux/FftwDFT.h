@@ -2,23 +2,59 @@
 #define WIRECELLAUX_FFTWDFT
 
 #include "WireCellIface/IDFT.h"
+#include "WireCellIface/IConfigurable.h"
+#include "WireCellIface/ITerminal.h"
+#include "WireCellAux/Logger.h"
 
 namespace WireCell::Aux {
 
     /** 
         The FftwDFT component provides IDFT based on FFTW3.
 
-        All instances share a common thread-safe plan cache.  There is
-        no benefit to using more than one instance in a process.
+        All instances share a common thread-safe plan cache.  Batched
+        (1b) transforms along either axis are made with a single
+        "plan many" and no transpose.
+
+        Configuration:
+
+        - nthreads :: number of threads FFTW may use for each
+          transform (default 1).  This requires FFTW threads support
+          at build time and is otherwise ignored.  Plans are cached
+          per number of threads so instances with different values
+          may coexist.
+
+        - planning :: planner rigor, one of "estimate" (default),
+          "measure", "patient" or "exhaustive".  Beyond "estimate",
+          plans take longer to make (on scratch arrays) and may run
+          faster.  The cost is paid once per process and shape unless
+          wisdom is reused.
+
+        - wisdom :: name of an FFTW wisdom file (default empty, none).
+          Any wisdom in the file is imported on configure().  A job
+          with the same planning and shapes then makes its plans
+          quickly.
+
+        - save_wisdom :: if true, export all accumulated wisdom to the
+          wisdom file on finalize() (default false).  Typically only
+          a "warm up" job sets this and many later jobs read the
+          file it produced.
 
         See IDFT.h for important comments.
     */
-    class FftwDFT : public IDFT {
+    class FftwDFT : public Aux::Logger,
+                    public IDFT, public IConfigurable, public ITerminal {
       public:
         
         FftwDFT();
         virtual ~FftwDFT();
 
+        // IConfigurable
+        virtual WireCell::Configuration default_configuration() const;
+        virtual void configure(const WireCell::Configuration& cfg);
+
+        // ITerminal
+        virtual void finalize();
+
         // 1d 
 
         virtual 
@@ -44,6 +80,32 @@ namespace WireCell::Aux {
         void inv2d(const complex_t* in, complex_t* out,
                    int nrows, int ncols) const;
 
+        // Real transforms use FFTW's r2c and c2r plans.
+
+        virtual
+        void fwd1d_r2c(const scalar_t* in, complex_t* out,
+                       int size) const;
+
+        virtual
+        void inv1d_c2r(const complex_t* in, scalar_t* out,
+                       int size) const;
+
+        virtual
+        void fwd1b_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols, int axis) const;
+
+        virtual
+        void inv1b_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols, int axis) const;
+
+        virtual
+        void fwd2d_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols) const;
+
+        virtual
+        void inv2d_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols) const;
+
         virtual
         void transpose(const scalar_t* in, scalar_t* out,
                        int nrows, int ncols) const;
@@ -51,6 +113,12 @@ namespace WireCell::Aux {
         void transpose(const complex_t* in, complex_t* out,
                        int nrows, int ncols) const;
 
+      private:
+        int m_nthreads{1};
+        std::string m_planning{"estimate"};
+        unsigned int m_rigor{0};
+        std::string m_wisdom{""};
+        bool m_save_wisdom{false};
     };
 }
 
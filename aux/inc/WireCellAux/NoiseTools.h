@@ -247,6 +247,11 @@ namespace WireCell::Aux::NoiseTools {
         virtual complex_vector_t spec(const real_vector_t& sigma);
         virtual real_vector_t wave(const real_vector_t& sigma);
 
+        // Add the first sigma.size()/2+1 elements of a spec() to
+        // half, as needed for a c2r transform.  This consumes the
+        // same randoms as spec() but avoids making the full spectrum.
+        void add_half_spec(const real_vector_t& sigma, std::complex<float>* half);
+
       private:
         IDFT::pointer dft;
         normal_f normal;
@@ -15,6 +15,9 @@ namespace WireCell::Aux::RandTools {
     // A generator that returns fresh randoms.
     using generator_f = std::function<double()>;
 
+    // Fill an array with fresh randoms in bulk.
+    using filler_f = std::function<void(float*, size_t)>;
+
     // A base for pseudo RNGs
     struct PRNG {
         virtual ~PRNG() {}
@@ -52,6 +55,13 @@ namespace WireCell::Aux::RandTools {
                   size_t capacity=1000,
                   double replacement_fraction=0.04);
 
+        // As above but the ring is filled by "fill", which should
+        // give randoms from the same distribution as "gen" but may
+        // do so faster.  See IRandom::fill_normal().
+        Recycling(generator_f gen, generator_f uni, filler_f fill,
+                  size_t capacity=1000,
+                  double replacement_fraction=0.04);
+
         // Return a single pseudo-pseudo-random 
         float operator()();
 
@@ -69,6 +79,7 @@ namespace WireCell::Aux::RandTools {
 
       private:
         generator_f gen, uni;
+        filler_f fill;
         size_t nreplace, replace;
         double repfrac{0.02};
         size_t cursor{0};  // may eventually roll over, we do not care
@@ -100,6 +111,9 @@ namespace WireCell::Aux::RandTools {
         {
             return RandTools::Recycling(rng->make_normal(mean, sigma),
                                         rng->make_uniform(0,1),
+                                        [rng, mean, sigma](float* out, size_t n) {
+                                            rng->fill_normal(out, n, mean, sigma);
+                                        },
                                         capacity, replacement_fraction);
         }
         inline
@@ -120,6 +134,9 @@ namespace WireCell::Aux::RandTools {
         {
             return RandTools::Recycling(rng->make_uniform(lo, hi),
                                         rng->make_uniform(0,1),
+                                        [rng, lo, hi](float* out, size_t n) {
+                                            rng->fill_uniform(out, n, lo, hi);
+                                        },
                                         capacity, replacement_fraction);
         }
 
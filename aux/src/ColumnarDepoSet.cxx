@@ -0,0 +1,155 @@
+#include "WireCellAux/ColumnarDepoSet.h"
+#include "WireCellUtil/Exceptions.h"
+
+using namespace WireCell;
+
+namespace {
+
+    using Table = Aux::ColumnarDepoSet::Table;
+
+    class DepoView : public IDepo {
+       public:
+        DepoView(const Table* table, size_t row);
+
+        virtual const Point& pos() const { return m_pos; }
+        virtual double time() const;
+        virtual double charge() const;
+        virtual double energy() const;
+        virtual int id() const;
+        virtual int pdg() const;
+        virtual IDepo::pointer prior() const;
+        virtual double extent_long() const;
+        virtual double extent_tran() const;
+
+       private:
+        const Table* m_table;
+        size_t m_row;
+        Point m_pos;            // pos() must return a reference
+        const DepoColumns& cols() const;
+    };
+}
+
+struct Aux::ColumnarDepoSet::Table : public std::enable_shared_from_this<Aux::ColumnarDepoSet::Table> {
+    DepoColumns cols;
+    std::vector<DepoView> views;
+
+    // Return a view sharing ownership of the whole table.
+    IDepo::pointer view(size_t row) const
+    {
+        return IDepo::pointer(shared_from_this(), &views[row]);
+    }
+};
+
+DepoView::DepoView(const Table* table, size_t row)
+  : m_table(table)
+  , m_row(row)
+  , m_pos(table->cols.x[row], table->cols.y[row], table->cols.z[row])
+{
+}
+
+const DepoColumns& DepoView::cols() const { return m_table->cols; }
+double DepoView::time() const { return cols().time[m_row]; }
+double DepoView::charge() const { return cols().charge[m_row]; }
+double DepoView::energy() const { return cols().energy[m_row]; }
+int DepoView::id() const { return cols().id[m_row]; }
+int DepoView::pdg() const { return cols().pdg[m_row]; }
+double DepoView::extent_long() const { return cols().extent_long[m_row]; }
+double DepoView::extent_tran() const { return cols().extent_tran[m_row]; }
+IDepo::pointer DepoView::prior() const
+{
+    const int row = cols().prior[m_row];
+    if (row < 0) {
+        return nullptr;
+    }
+    return m_table->view(row);
+}
+
+Aux::ColumnarDepoSet::ColumnarDepoSet(int ident, DepoColumns columns)
+  : m_ident(ident)
+  , m_table(std::make_shared<Table>())
+{
+    const size_t nrows = columns.size();
+    for (const auto* col : {&columns.charge, &columns.energy, &columns.x, &columns.y, &columns.z,
+                            &columns.extent_long, &columns.extent_tran}) {
+        if (col->size() != nrows) {
+            raise<ValueError>("ColumnarDepoSet: column size %d does not match %d rows", col->size(), nrows);
+        }
+    }
+    for (const auto* col : {&columns.id, &columns.pdg, &columns.prior}) {
+        if (col->size() != nrows) {
+            raise<ValueError>("ColumnarDepoSet: column size %d does not match %d rows", col->size(), nrows);
+        }
+    }
+    for (auto row : columns.active) {
+        if (row >= nrows) {
+            raise<ValueError>("ColumnarDepoSet: active row %d out of %d rows", row, nrows);
+        }
+    }
+    m_table->cols = std::move(columns);
+}
+
+Aux::ColumnarDepoSet::~ColumnarDepoSet() {}
+
+const DepoColumns* Aux::ColumnarDepoSet::columns() const { return &m_table->cols; }
+
+IDepo::shared_vector Aux::ColumnarDepoSet::depos() const
+{
+    std::call_once(m_once, [&]() {
+        auto& table = *m_table;
+        const size_t nrows = table.cols.size();
+        table.views.reserve(nrows);
+        for (size_t row = 0; row < nrows; ++row) {
+            table.views.emplace_back(&table, row);
+        }
+        auto depos = std::make_shared<IDepo::vector>();
+        depos->reserve(table.cols.active.size());
+        for (auto row : table.cols.active) {
+            depos->push_back(table.view(row));
+        }
+        m_depos = depos;
+    });
+    return m_depos;
+}
+
+size_t Aux::append(DepoColumns& cols, const IDepo& depo, int prior)
+{
+    const auto& pos = depo.pos();
+    cols.time.push_back(depo.time());
+    cols.charge.push_back(depo.charge());
+    cols.energy.push_back(depo.energy());
+    cols.x.push_back(pos.x());
+    cols.y.push_back(pos.y());
+    cols.z.push_back(pos.z());
+    cols.extent_long.push_back(depo.extent_long());
+    cols.extent_tran.push_back(depo.extent_tran());
+    cols.id.push_back(depo.id());
+    cols.pdg.push_back(depo.pdg());
+    cols.prior.push_back(prior);
+    return cols.size() - 1;
+}
+
+template <typename T>
+static void append_column(std::vector<T>& dst, const std::vector<T>& src)
+{
+    dst.insert(dst.end(), src.begin(), src.end());
+}
+
+size_t Aux::append(DepoColumns& dst, const DepoColumns& src)
+{
+    const size_t offset = dst.size();
+    append_column(dst.time, src.time);
+    append_column(dst.charge, src.charge);
+    append_column(dst.energy, src.energy);
+    append_column(dst.x, src.x);
+    append_column(dst.y, src.y);
+    append_column(dst.z, src.z);
+    append_column(dst.extent_long, src.extent_long);
+    append_column(dst.extent_tran, src.extent_tran);
+    append_column(dst.id, src.id);
+    append_column(dst.pdg, src.pdg);
+    dst.prior.reserve(dst.prior.size() + src.prior.size());
+    for (int prior : src.prior) {
+        dst.prior.push_back(prior < 0 ? prior : prior + (int) offset);
+    }
+    return offset;
+}
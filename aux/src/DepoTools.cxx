@@ -121,6 +121,32 @@ IDepo::vector Aux::sensitive(const IDepo::vector& depos, IAnodeFace::pointer fac
     }
     return ret;
 }
+IDepo::vector Aux::sensitive(IDepoSet::pointer deposet, IAnodeFace::pointer face)
+{
+    const auto* cols = deposet->columns();
+    if (!cols) {
+        return sensitive(*deposet->depos(), face);
+    }
+    IDepo::vector ret;
+    auto bb = face->sensitive();
+    if (bb.empty()) {
+        return ret;
+    }
+    IDepo::shared_vector depos;  // only made if needed
+    const auto& active = cols->active;
+    for (size_t ind = 0; ind < active.size(); ++ind) {
+        const size_t row = active[ind];
+        if (!bb.inside(Point(cols->x[row], cols->y[row], cols->z[row]))) {
+            continue;
+        }
+        if (!depos) {
+            depos = deposet->depos();
+        }
+        ret.push_back(depos->at(ind));
+    }
+    return ret;
+}
+
 IDepo::vector Aux::sensitive(const IDepo::vector& depos, IAnodePlane::pointer anode)
 {
     IDepo::vector ret;
@@ -1,21 +1,62 @@
 #include "WireCellAux/FftwDFT.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/BuildConfig.h"
 
 #include <fftw3.h>
+#include <map>
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
-WIRECELL_FACTORY(FftwDFT, WireCell::Aux::FftwDFT, WireCell::IDFT)
+WIRECELL_FACTORY(FftwDFT, WireCell::Aux::FftwDFT,
+                 WireCell::IDFT, WireCell::IConfigurable,
+                 WireCell::ITerminal, WireCell::INamed)
 
 
 using namespace WireCell;
 
 using plan_key_t = int64_t;
 using plan_type = fftwf_plan;
-using plan_map_t = std::unordered_map<plan_key_t, plan_type>;
 using plan_val_t = fftwf_complex;
 
+// Plans made for a different number of threads or planning rigor are
+// distinct.
+using plan_opts_key_t = std::tuple<plan_key_t, int, unsigned int>;
+struct plan_key_hash {
+    size_t operator()(const plan_opts_key_t& k) const {
+        size_t h = std::hash<plan_key_t>()(std::get<0>(k));
+        h ^= std::hash<int>()(std::get<1>(k)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<unsigned int>()(std::get<2>(k)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+using plan_map_t = std::unordered_map<plan_opts_key_t, plan_type, plan_key_hash>;
+
+// The FFTW planner and its wisdom are global and not thread safe.
+static std::mutex& planner_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Have subsequent plans use nthreads, if FFTW threads are available.
+static void planner_nthreads(int nthreads)
+{
+#if HAVE_FFTWTHREADS_LIB
+    static std::once_flag once;
+    std::call_once(once, []() { fftwf_init_threads(); });
+    fftwf_plan_with_nthreads(nthreads);
+#endif
+}
+
+// True if FFTW considers the array SIMD aligned.
+static
+bool is_aligned(const void* p)
+{
+    return fftwf_alignment_of(reinterpret_cast<float*>(const_cast<void*>(p))) == 0;
+}
+
 // Make a key by which a plan is known.  dir should be FFTW_FORWARD or
 // FFTW_BACKWARD and "axis" is -1 for all or in {0,1} for one of 2D.
 // For 1D, use the default axis=-1.
@@ -29,14 +70,14 @@ plan_key_t make_key(const void * src, void * dst, int nrows, int ncols, int dir,
     ++axis;                     // need three positive values, default is both axis 
     bool inverse = dir == FFTW_BACKWARD;
     bool inplace = (dst==src);
-    bool aligned = ( (reinterpret_cast<size_t>(src)&15) | (reinterpret_cast<size_t>(dst)&15) ) == 0;
+    bool aligned = is_aligned(src) and is_aligned(dst);
     int64_t key = ( ( (((int64_t)nrows) << 32)| (ncols<<5 ) | (axis<<3) | (inverse<<2) | (inplace<<1) | aligned ) << 1 ) + 1;
     return key;
 }
 
 // Look up a plan by key or return NULL
 static
-plan_type get_plan(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key)
+plan_type get_plan(std::shared_mutex& mutex, plan_map_t& plans, const plan_opts_key_t& key)
 {
     std::shared_lock lock(mutex);
     auto it = plans.find(key);
@@ -49,16 +90,52 @@ plan_type get_plan(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key)
 
 // #include <iostream>             // debugging
 
-using planner_function = std::function<plan_type()>;
+// Call make_plan(flags, src, dst) with the rigor flag.  Plans are cached and later
+// executed on other arrays of the same key.  Unaligned plans are thus
+// made to accept any alignment.  All but FFTW_ESTIMATE overwrite the
+// arrays while planning so then plan on scratch arrays of nsrc and
+// ndst elements.
+template<typename ValueType, typename OutType, typename MakePlan>
+plan_type make_plan_with(unsigned int rigor,
+                         ValueType* src, size_t nsrc, OutType* dst, size_t ndst,
+                         MakePlan make_plan)
+{
+    unsigned int flags = rigor;
+    if (! (is_aligned(src) and is_aligned(dst))) {
+        flags |= FFTW_UNALIGNED;
+    }
+    if (rigor == FFTW_ESTIMATE) {
+        return make_plan(flags, src, dst);
+    }
+
+    const bool inplace = (void*)src == (void*)dst;
+    const size_t sbytes = nsrc*sizeof(ValueType);
+    const size_t dbytes = ndst*sizeof(OutType);
+    if (inplace) {
+        void* scratch = fftwf_malloc(std::max(sbytes, dbytes));
+        auto plan = make_plan(flags, (ValueType*)scratch, (OutType*)scratch);
+        fftwf_free(scratch);
+        return plan;
+    }
+    void* ssrc = fftwf_malloc(sbytes);
+    void* sdst = fftwf_malloc(dbytes);
+    auto plan = make_plan(flags, (ValueType*)ssrc, (OutType*)sdst);
+    fftwf_free(ssrc);
+    fftwf_free(sdst);
+    return plan;
+}
 
 // This wraps plan lookup, possible plan creation and subsequent plan
-// execution so that we get thread-safe plan caching.
-template<typename ValueType>
-void doit(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key,
-          ValueType* src, ValueType* dst,
-          planner_function make_plan,
-          std::function<void(const plan_type, ValueType*, ValueType*)> exec_plan)
+// execution so that we get thread-safe plan caching.  The nsrc and
+// ndst give the number of elements of the src and dst arrays.
+template<typename ValueType, typename OutType = ValueType, typename MakePlan, typename ExecPlan>
+void doit(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t shape_key,
+          int nthreads, unsigned int rigor,
+          ValueType* src, size_t nsrc, OutType* dst, size_t ndst,
+          MakePlan make_plan,
+          ExecPlan exec_plan)
 {
+    const plan_opts_key_t key(shape_key, nthreads, rigor);
     auto plan = get_plan(mutex, plans, key);
     if (!plan) {
         std::unique_lock lock(mutex);
@@ -66,7 +143,9 @@ void doit(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key,
         auto it = plans.find(key);
         if (it == plans.end()) {
             //std::cerr << "make plan for " << key << std::endl;
-            plan = make_plan();
+            std::lock_guard<std::mutex> plock(planner_mutex());
+            planner_nthreads(nthreads);
+            plan = make_plan_with(rigor, src, nsrc, dst, ndst, make_plan);
             plans[key] = plan;
         }
         else {
@@ -93,8 +172,8 @@ void Aux::FftwDFT::fwd1d(const complex_t* in, complex_t* out, int ncols) const
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, 1, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_1d(ncols, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, ncols, dst, ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_1d(ncols, psrc, pdst, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 }
 void Aux::FftwDFT::inv1d(const complex_t* in, complex_t* out, int ncols) const
@@ -106,8 +185,8 @@ void Aux::FftwDFT::inv1d(const complex_t* in, complex_t* out, int ncols) const
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, 1, ncols, dir);
 
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_1d(ncols, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, ncols, dst, ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_1d(ncols, psrc, pdst, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 
     // Apply 1/n normalization
@@ -118,7 +197,7 @@ void Aux::FftwDFT::inv1d(const complex_t* in, complex_t* out, int ncols) const
 
 
 fftwf_plan plan_1b(fftwf_complex *in, fftwf_complex *out,
-                   int nrows, int ncols, int sign, int axis)
+                   int nrows, int ncols, int sign, int axis, unsigned int flags)
 {
     // (r,c) element at in + r*stride + c*dist
 
@@ -135,7 +214,7 @@ fftwf_plan plan_1b(fftwf_complex *in, fftwf_complex *out,
     }
     int *inembed=&n, *onembed=&n;
 
-    unsigned int flags =  FFTW_ESTIMATE|FFTW_PRESERVE_INPUT;
+    flags |= FFTW_PRESERVE_INPUT;
 
     return fftwf_plan_many_dft(rank, &n, howmany,
                                in, inembed,
@@ -155,8 +234,8 @@ void Aux::FftwDFT::fwd1b(const complex_t* in, complex_t* out, int nrows, int nco
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, nrows, ncols, dir, axis);
 
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return plan_1b(src, dst, nrows, ncols, dir, axis);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return plan_1b(psrc, pdst, nrows, ncols, dir, axis, flags);
     }, fftwf_execute_dft);
 }
 
@@ -170,8 +249,8 @@ void Aux::FftwDFT::inv1b(const complex_t* in, complex_t* out, int nrows, int nco
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, nrows, ncols, dir, axis);
 
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return plan_1b(src, dst, nrows, ncols, dir, axis);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return plan_1b(psrc, pdst, nrows, ncols, dir, axis, flags);
     }, fftwf_execute_dft);
 
     // 1/n normalization
@@ -191,8 +270,8 @@ void Aux::FftwDFT::fwd2d(const complex_t* in, complex_t* out, int nrows, int nco
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_2d(ncols, nrows, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_2d(ncols, nrows, psrc, pdst, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 }
 
@@ -205,8 +284,8 @@ void Aux::FftwDFT::inv2d(const complex_t* in, complex_t* out, int nrows, int nco
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_2d(ncols, nrows, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_2d(ncols, nrows, psrc, pdst, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 
     // reverse normalization
@@ -217,11 +296,147 @@ void Aux::FftwDFT::inv2d(const complex_t* in, complex_t* out, int nrows, int nco
 }
 
 
+/*** real to complex and complex to real ***/
+
+// Real data is in units of float, spectra of fftwf_complex.
+static
+float* rval_cast(const IDFT::scalar_t* p)
+{
+    return const_cast<float*>(p);
+}
+
+// Make a plan for nrows (axis=1) or ncols (axis=0) r2c or c2r
+// transforms.  The nrows/ncols are of the real array.  The complex
+// array is halved along the transformed dimension.
+static
+plan_type plan_1b_real(float* rdata, fftwf_complex* cdata, int nrows, int ncols, int axis, bool forward,
+                       unsigned int flags)
+{
+    const int rank = 1;
+    int n = ncols;
+    int howmany = nrows;
+    int stride = 1;
+    int rdist = ncols, cdist = ncols/2 + 1;
+    if (axis == 0) {
+        n = nrows;
+        howmany = ncols;
+        stride = ncols;
+        rdist = cdist = 1;
+    }
+    // rank=1 c2r supports preserving input.
+    flags |= FFTW_PRESERVE_INPUT;
+    if (forward) {
+        return fftwf_plan_many_dft_r2c(rank, &n, howmany,
+                                       rdata, NULL, stride, rdist,
+                                       cdata, NULL, stride, cdist,
+                                       flags);
+    }
+    return fftwf_plan_many_dft_c2r(rank, &n, howmany,
+                                   cdata, NULL, stride, cdist,
+                                   rdata, NULL, stride, rdist,
+                                   flags);
+}
+
+void Aux::FftwDFT::fwd1d_r2c(const scalar_t* in, complex_t* out, int size) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    auto src = rval_cast(in);
+    auto dst = pval_cast(out);
+    auto key = make_key(src, dst, 1, size, FFTW_FORWARD);
+    doit<float, plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, size, dst, size/2+1, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_r2c_1d(size, psrc, pdst, flags|FFTW_PRESERVE_INPUT);
+    }, fftwf_execute_dft_r2c);
+}
+
+void Aux::FftwDFT::inv1d_c2r(const complex_t* in, scalar_t* out, int size) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    auto src = pval_cast(in);
+    auto dst = out;
+    auto key = make_key(src, dst, 1, size, FFTW_BACKWARD);
+    doit<plan_val_t, float>(mutex, plans, key, m_nthreads, m_rigor, src, size/2+1, dst, size, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_c2r_1d(size, psrc, pdst, flags|FFTW_PRESERVE_INPUT);
+    }, fftwf_execute_dft_c2r);
+
+    for (int ind=0; ind<size; ++ind) {
+        out[ind] /= size;
+    }
+}
+
+void Aux::FftwDFT::fwd1b_r2c(const scalar_t* in, complex_t* out, int nrows, int ncols, int axis) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    auto src = rval_cast(in);
+    auto dst = pval_cast(out);
+    auto key = make_key(src, dst, nrows, ncols, FFTW_FORWARD, axis);
+    const int nhalf = axis ? nrows*(ncols/2+1) : (nrows/2+1)*ncols;
+    doit<float, plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nhalf, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return plan_1b_real(psrc, pdst, nrows, ncols, axis, true, flags);
+    }, fftwf_execute_dft_r2c);
+}
+
+void Aux::FftwDFT::inv1b_c2r(const complex_t* in, scalar_t* out, int nrows, int ncols, int axis) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    auto src = pval_cast(in);
+    auto dst = out;
+    auto key = make_key(src, dst, nrows, ncols, FFTW_BACKWARD, axis);
+    const int nhalf = axis ? nrows*(ncols/2+1) : (nrows/2+1)*ncols;
+    doit<plan_val_t, float>(mutex, plans, key, m_nthreads, m_rigor, src, nhalf, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return plan_1b_real(pdst, psrc, nrows, ncols, axis, false, flags);
+    }, fftwf_execute_dft_c2r);
+
+    const int norm = axis ? ncols : nrows;
+    const int ntot = ncols*nrows;
+    for (int ind=0; ind<ntot; ++ind) {
+        out[ind] /= norm;
+    }
+}
+
+void Aux::FftwDFT::fwd2d_r2c(const scalar_t* in, complex_t* out, int nrows, int ncols) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    auto src = rval_cast(in);
+    auto dst = pval_cast(out);
+    auto key = make_key(src, dst, nrows, ncols, FFTW_FORWARD);
+    doit<float, plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*(ncols/2+1), [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_r2c_2d(nrows, ncols, psrc, pdst, flags|FFTW_PRESERVE_INPUT);
+    }, fftwf_execute_dft_r2c);
+}
+
+void Aux::FftwDFT::inv2d_c2r(const complex_t* in, scalar_t* out, int nrows, int ncols) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+
+    // FFTW can not preserve the input of multi-dimensional c2r so
+    // work on a copy.
+    const int nhalf = ncols/2 + 1;
+    std::vector<complex_t> tmp(in, in + nrows*nhalf);
+
+    auto src = pval_cast(tmp.data());
+    auto dst = out;
+    auto key = make_key(src, dst, nrows, ncols, FFTW_BACKWARD);
+    doit<plan_val_t, float>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*nhalf, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return fftwf_plan_dft_c2r_2d(nrows, ncols, psrc, pdst, flags|FFTW_DESTROY_INPUT);
+    }, fftwf_execute_dft_c2r);
+
+    const int ntot = ncols*nrows;
+    for (int ind=0; ind<ntot; ++ind) {
+        out[ind] /= ntot;
+    }
+}
+
+
 // based on example from fftw3 faq
 static
-plan_type transpose_plan_complex(plan_val_t *in, plan_val_t *out, int rows, int cols)
+plan_type transpose_plan_complex(plan_val_t *in, plan_val_t *out, int rows, int cols, unsigned flags)
 {
-    const unsigned flags = FFTW_ESTIMATE; /* other flags are possible */
     fftw_iodim howmany_dims[2];
 
     howmany_dims[0].n  = rows;
@@ -245,15 +460,14 @@ void Aux::FftwDFT::transpose(const complex_t* in, complex_t* out,
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
     auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return transpose_plan_complex(src, dst, nrows, ncols);
+    doit<plan_val_t>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return transpose_plan_complex(psrc, pdst, nrows, ncols, flags);
     }, fftwf_execute_dft);
 }
 
 static
-plan_type transpose_plan_real(float *in, float *out, int rows, int cols)
+plan_type transpose_plan_real(float *in, float *out, int rows, int cols, unsigned flags)
 {
-    const unsigned flags = FFTW_ESTIMATE; /* other flags are possible */
     fftw_iodim howmany_dims[2];
 
     howmany_dims[0].n  = rows;
@@ -277,15 +491,81 @@ void Aux::FftwDFT::transpose(const scalar_t* in, scalar_t* out,
     auto src = const_cast<scalar_t*>(in);
     auto dst = out;
     auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<float>(mutex, plans, key, src, dst, [&]( ) {
-        return transpose_plan_real(src, dst, nrows, ncols);
+    doit<float>(mutex, plans, key, m_nthreads, m_rigor, src, nrows*ncols, dst, nrows*ncols, [&](unsigned int flags, auto* psrc, auto* pdst) {
+        return transpose_plan_real(psrc, pdst, nrows, ncols, flags);
     }, fftwf_execute_r2r);
 }
 
 Aux::FftwDFT::FftwDFT()
+    : Aux::Logger("FftwDFT", "aux")
+    , m_rigor(FFTW_ESTIMATE)
 {
 }
 Aux::FftwDFT::~FftwDFT()
 {
 }
 
+WireCell::Configuration Aux::FftwDFT::default_configuration() const
+{
+    Configuration cfg;
+    cfg["nthreads"] = m_nthreads;
+    cfg["planning"] = m_planning;
+    cfg["wisdom"] = m_wisdom;
+    cfg["save_wisdom"] = m_save_wisdom;
+    return cfg;
+}
+
+void Aux::FftwDFT::configure(const WireCell::Configuration& cfg)
+{
+    m_nthreads = get(cfg, "nthreads", m_nthreads);
+    if (m_nthreads < 1) {
+        raise<ValueError>("FftwDFT: nthreads must be positive, got %d", m_nthreads);
+    }
+#if ! HAVE_FFTWTHREADS_LIB
+    if (m_nthreads > 1) {
+        log->warn("built without FFTW threads, ignoring nthreads={}", m_nthreads);
+        m_nthreads = 1;
+    }
+#endif
+
+    const std::map<std::string, unsigned int> rigors = {
+        {"estimate", FFTW_ESTIMATE},
+        {"measure", FFTW_MEASURE},
+        {"patient", FFTW_PATIENT},
+        {"exhaustive", FFTW_EXHAUSTIVE},
+    };
+    m_planning = get(cfg, "planning", m_planning);
+    auto rit = rigors.find(m_planning);
+    if (rit == rigors.end()) {
+        raise<ValueError>("FftwDFT: unknown planning \"%s\"", m_planning);
+    }
+    m_rigor = rit->second;
+
+    m_wisdom = get(cfg, "wisdom", m_wisdom);
+    m_save_wisdom = get(cfg, "save_wisdom", m_save_wisdom);
+    if (m_wisdom.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> plock(planner_mutex());
+    if (fftwf_import_wisdom_from_filename(m_wisdom.c_str())) {
+        log->debug("imported FFTW wisdom from {}", m_wisdom);
+    }
+    else {
+        log->debug("no FFTW wisdom imported from {}", m_wisdom);
+    }
+}
+
+void Aux::FftwDFT::finalize()
+{
+    if (m_wisdom.empty() or !m_save_wisdom) {
+        return;
+    }
+    std::lock_guard<std::mutex> plock(planner_mutex());
+    if (fftwf_export_wisdom_to_filename(m_wisdom.c_str())) {
+        log->debug("exported FFTW wisdom to {}", m_wisdom);
+    }
+    else {
+        log->warn("failed to export FFTW wisdom to {}", m_wisdom);
+    }
+}
+
@@ -209,6 +209,30 @@ GeneratorN::wave(const real_vector_t& sigmas)
     return inv_c2r(dft, spec(sigmas));
 }
 
+void
+GeneratorN::add_half_spec(const real_vector_t& sigmas, std::complex<float>* half)
+{
+    const size_t nsamples = sigmas.size();
+    if (!nsamples) {
+        return;
+    }
+    // As in spec() above.
+    const size_t nextra = (nsamples+1)%2;
+    const size_t nhalf = nsamples / 2;
+
+    auto normals = normal(2*(nhalf+nextra)+1);
+
+    // DC and any Nyquist bin must be real.
+    for (size_t ind=0; ind <= nhalf; ++ind) {
+        const float mode = sigmas[ind];
+        std::complex<float> val(mode*normals[ind], mode*normals[ind+nhalf]);
+        if (ind == 0 or (nextra and ind == nhalf)) {
+            val = std::abs(val);
+        }
+        half[ind] += val;
+    }
+}
+
 
 //
 // GeneratorU
@@ -12,13 +12,25 @@ Recycling::Recycling(generator_f gen, generator_f uni,
     resize(capacity);
 }
 
+Recycling::Recycling(generator_f gen, generator_f uni, filler_f fill,
+                     size_t capacity, double replacement_fraction)
+    : gen(gen), uni(uni), fill(fill), repfrac(replacement_fraction)
+{
+    resize(capacity);
+}
+
 void Recycling::resize(size_t capacity)
 {
     const size_t oldsize = ring.size();
     ring.resize(capacity, 0);
     if (capacity > oldsize) {
-        for (size_t ind=oldsize; ind<capacity; ++ind) {
-            ring[ind] = gen();
+        if (fill) {
+            fill(ring.data() + oldsize, capacity - oldsize);
+        }
+        else {
+            for (size_t ind=oldsize; ind<capacity; ++ind) {
+                ring[ind] = gen();
+            }
         }
     }
     size_t jump = 1/repfrac;
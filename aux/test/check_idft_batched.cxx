@@ -0,0 +1,102 @@
+/**
+   Benchmark batched (1b) IDFT transforms against the per-row loop
+   that IDFT provides by default, for array shapes typical of
+   detector frames.
+
+   The per-row variant calls the IDFT base class implementation which
+   calls fwd1d()/inv1d() once per row and transposes for axis=0.  The
+   batched variant calls the IDFT implementation directly.  For
+   FftwDFT, the "nthreads", "planning" and "wisdom" configuration
+   parameters may be given with the usual -c option.
+ */
+
+#include "aux_test_dft_helpers.h"
+
+#include "WireCellIface/ITerminal.h"
+
+using namespace WireCell;
+using namespace WireCell::Aux::Test;
+
+using complex_t = std::complex<float>;
+using transform_function = std::function<void(const complex_t* in, complex_t* out)>;
+
+const int nominal = 100'000'000;
+void doit(Stopwatch& sw, const std::string& name, const std::string& method,
+          int nrows, int ncols, transform_function func)
+{
+    const int size = nrows*ncols;
+    const int ntimes = std::max(1, nominal / size);
+
+    std::vector<complex_t> in(size, 1), out(size);
+
+    // first call includes planning
+    sw([&](){ func(in.data(), out.data()); }, {
+            {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"method",method},
+            {"ntimes",1}, {"first",true},
+        });
+
+    sw([&](){
+        for (int count=0; count<ntimes; ++count) {
+            func(in.data(), out.data());
+        }}, {
+            {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"method",method},
+            {"ntimes",ntimes}, {"first",false},
+        });
+    const double dt = sw.results.back()["stopwatch"]["time"]["elapsed"];
+    std::cerr << name << " " << method << ": (" << nrows << "," << ncols << ") x "
+              << ntimes << ": " << dt/ntimes/1e6 << " ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+    DftArgs args;
+    int rc = make_dft_args(args, argc, argv);
+    if (rc) { return rc; }
+
+    auto idft = make_dft(args.tn, args.pi, args.cfg);
+
+    Stopwatch sw({
+            {"typename",args.tn},
+            {"plugin",args.pi},
+            {"config", object_t::parse(Persist::dumps(args.cfg))},
+            {"config_file",args.cfg_name}});
+
+    // channel count and readout length from some detectors
+    std::vector<std::pair<int,int>> twod_sizes{
+        {800,6000}, {960,6000}, // protodune u/v and w 3ms
+        {2400, 9595}, {3456, 9595}, // uboone u/v daq size
+    };
+    for (const auto& two: twod_sizes) {
+        const int nrows = two.first;
+        const int ncols = two.second;
+        for (int axis : {1, 0}) {
+            const std::string fwd = "fwd1b" + std::to_string(axis);
+            const std::string inv = "inv1b" + std::to_string(axis);
+
+            doit(sw, fwd, "perrow", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+                idft->IDFT::fwd1b(in, out, nrows, ncols, axis);
+            });
+            doit(sw, fwd, "batched", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+                idft->fwd1b(in, out, nrows, ncols, axis);
+            });
+            doit(sw, inv, "perrow", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+                idft->IDFT::inv1b(in, out, nrows, ncols, axis);
+            });
+            doit(sw, inv, "batched", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+                idft->inv1b(in, out, nrows, ncols, axis);
+            });
+        }
+    }
+
+    // Let FftwDFT save any wisdom.
+    auto iterm = Factory::find_maybe_tn<ITerminal>(args.tn);
+    if (iterm) {
+        iterm->finalize();
+    }
+
+    if (! args.output.empty()) {
+        std::cerr << "writing to: " << args.output << std::endl;
+        sw.save(args.output);
+    }
+    return 0;
+}
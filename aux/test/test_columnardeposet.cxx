@@ -0,0 +1,68 @@
+// Check Aux::ColumnarDepoSet gives IDepo views equal to its columns.
+#include "WireCellAux/ColumnarDepoSet.h"
+#include "WireCellAux/SimpleDepo.h"
+#include "WireCellUtil/Exceptions.h"
+#include "WireCellUtil/Testing.h"
+
+using namespace WireCell;
+
+int main()
+{
+    // Two active depos, the first with a prior.
+    Aux::SimpleDepo orig(10 * units::us, Point(1, 2, 3), 1000, nullptr, 0, 0, 7, 11, 0.5);
+    Aux::SimpleDepo drifted(20 * units::us, Point(0, 2, 3), 900, nullptr, 1 * units::mm, 2 * units::mm, 7, 11, 0.5);
+    Aux::SimpleDepo other(30 * units::us, Point(4, 5, 6), 500);
+
+    DepoColumns cols;
+    cols.active.push_back(Aux::append(cols, drifted, 2));
+    cols.active.push_back(Aux::append(cols, other));
+    Aux::append(cols, orig);
+    Assert(cols.size() == 3);
+
+    IDepo::shared_vector depos;
+    {
+        auto ds = std::make_shared<Aux::ColumnarDepoSet>(42, cols);
+        Assert(ds->ident() == 42);
+        Assert(ds->columns()->size() == 3);
+        depos = ds->depos();
+        Assert(depos == ds->depos());
+    }
+    // The views keep the columns alive.
+    Assert(depos->size() == 2);
+
+    const auto& d0 = depos->at(0);
+    Assert(d0->time() == drifted.time());
+    Assert(d0->pos() == drifted.pos());
+    Assert(d0->charge() == drifted.charge());
+    Assert(d0->energy() == drifted.energy());
+    Assert(d0->extent_long() == drifted.extent_long());
+    Assert(d0->extent_tran() == drifted.extent_tran());
+    Assert(d0->id() == 7 and d0->pdg() == 11);
+
+    auto prior = d0->prior();
+    Assert(prior);
+    Assert(prior->pos() == orig.pos());
+    Assert(prior->time() == orig.time());
+    Assert(!prior->prior());
+    Assert(!depos->at(1)->prior());
+    Assert(depos->at(1)->charge() == other.charge());
+
+    // Appending a table shifts its priors.
+    DepoColumns more;
+    Aux::append(more, other);
+    const size_t offset = Aux::append(more, cols);
+    Assert(offset == 1 and more.size() == 4);
+    Assert(more.prior[1] == 3 and more.prior[3] == -1);
+
+    // Inconsistent columns are rejected.
+    cols.x.pop_back();
+    bool caught = false;
+    try {
+        Aux::ColumnarDepoSet bad(0, cols);
+    }
+    catch (const ValueError&) {
+        caught = true;
+    }
+    Assert(caught);
+    return 0;
+}
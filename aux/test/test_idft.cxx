@@ -8,6 +8,7 @@
 #include <thread>
 #include <numeric>
 #include <iostream>
+#include <cmath>
 
 using namespace WireCell;
 using namespace WireCell::Aux::Test;
@@ -202,6 +203,94 @@ void test_2d_transpose(IDFT::pointer dft, int nrows, int ncols)
 }
 
 
+// Provide only the complex methods so that IDFT's default real
+// methods are exercised.
+class ComplexOnly : public IDFT {
+    IDFT::pointer m_dft;
+  public:
+    ComplexOnly(IDFT::pointer dft) : m_dft(dft) {}
+    virtual ~ComplexOnly() {}
+    virtual void fwd1d(const complex_t* in, complex_t* out, int size) const {
+        m_dft->fwd1d(in, out, size);
+    }
+    virtual void inv1d(const complex_t* in, complex_t* out, int size) const {
+        m_dft->inv1d(in, out, size);
+    }
+    virtual void fwd2d(const complex_t* in, complex_t* out, int nrows, int ncols) const {
+        m_dft->fwd2d(in, out, nrows, ncols);
+    }
+    virtual void inv2d(const complex_t* in, complex_t* out, int nrows, int ncols) const {
+        m_dft->inv2d(in, out, nrows, ncols);
+    }
+};
+
+// Compare r2c against c2c and check c2r round trip.
+static
+void test_real(IDFT::pointer dft, int nrows, int ncols)
+{
+    std::cerr << "real nrows="<<nrows<<" ncols="<<ncols<<"\n";
+    const int size = nrows*ncols;
+    std::vector<IDFT::scalar_t> wave(size);
+    for (int ind=0; ind<size; ++ind) {
+        wave[ind] = std::sin(0.1*ind*ind) + 0.5;
+    }
+    std::vector<IDFT::complex_t> cwave(wave.begin(), wave.end()), cspec(size);
+    std::vector<IDFT::scalar_t> back(size);
+
+    // 1d over the whole array
+    {
+        const int nhalf = size/2 + 1;
+        std::vector<IDFT::complex_t> hspec(nhalf);
+        dft->fwd1d(cwave.data(), cspec.data(), size);
+        dft->fwd1d_r2c(wave.data(), hspec.data(), size);
+        for (int ind=0; ind<nhalf; ++ind) {
+            assert_small(std::abs(hspec[ind] - cspec[ind]), 1e-4*size);
+        }
+        dft->inv1d_c2r(hspec.data(), back.data(), size);
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(back[ind] - wave[ind]), 1e-4);
+        }
+    }
+
+    // 1b along each axis
+    for (int axis : {0, 1}) {
+        const int hrows = axis ? nrows : nrows/2+1;
+        const int hcols = axis ? ncols/2+1 : ncols;
+        std::vector<IDFT::complex_t> hspec(hrows*hcols);
+        dft->fwd1b(cwave.data(), cspec.data(), nrows, ncols, axis);
+        dft->fwd1b_r2c(wave.data(), hspec.data(), nrows, ncols, axis);
+        for (int irow=0; irow<hrows; ++irow) {
+            for (int icol=0; icol<hcols; ++icol) {
+                auto diff = hspec[irow*hcols + icol] - cspec[irow*ncols + icol];
+                assert_small(std::abs(diff), 1e-4*size);
+            }
+        }
+        dft->inv1b_c2r(hspec.data(), back.data(), nrows, ncols, axis);
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(back[ind] - wave[ind]), 1e-4);
+        }
+    }
+
+    // 2d, compared to 1b along both axes
+    {
+        const int hcols = ncols/2+1;
+        std::vector<IDFT::complex_t> hspec(nrows*hcols);
+        dft->fwd1b(cwave.data(), cspec.data(), nrows, ncols, 1);
+        dft->fwd1b(cspec.data(), cspec.data(), nrows, ncols, 0);
+        dft->fwd2d_r2c(wave.data(), hspec.data(), nrows, ncols);
+        for (int irow=0; irow<nrows; ++irow) {
+            for (int icol=0; icol<hcols; ++icol) {
+                auto diff = hspec[irow*hcols + icol] - cspec[irow*ncols + icol];
+                assert_small(std::abs(diff), 1e-4*size);
+            }
+        }
+        dft->inv2d_c2r(hspec.data(), back.data(), nrows, ncols);
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(back[ind] - wave[ind]), 1e-4);
+        }
+    }
+}
+
 int main(int argc, char* argv[])
 {
     DftArgs args;
@@ -224,6 +313,12 @@ int main(int argc, char* argv[])
     test_2d_transpose<IDFT::complex_t>(idft, 2, 8);
     test_2d_transpose<IDFT::complex_t>(idft, 8, 2);
 
+    auto cdft = std::make_shared<ComplexOnly>(idft);
+    for (auto shape : std::vector<std::pair<int,int>>{{8,8}, {7,10}, {10,7}, {1,9}, {64,33}}) {
+        test_real(idft, shape.first, shape.second);
+        test_real(cdft, shape.first, shape.second);
+    }
+
     std::vector<int> sizes = {128,256,512,1024};
     for (auto size : sizes) {
         int ndouble=3, ntot=2*16384/size;
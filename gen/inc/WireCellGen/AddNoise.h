@@ -3,6 +3,11 @@
 // determins the noise waveform length so should be made to coincide
 // with the length of input waveforms.  Thus, this component works
 // only on rectangular, dense frames
+//
+// Noise spectra of a block of traces are made together and inverse
+// transformed by one batched DFT.  IncoherentAddNoise may transform
+// blocks in parallel with "nthreads".  The random sequence, and thus
+// the output, does not depend on the number of threads.
 
 #ifndef WIRECELL_GEN_ADDNOISE
 #define WIRECELL_GEN_ADDNOISE
@@ -25,8 +30,16 @@ namespace WireCell::Gen {
         IncoherentAddNoise();
         virtual ~IncoherentAddNoise();
 
+        /// IConfigurable
+        virtual void configure(const WireCell::Configuration& config);
+        virtual WireCell::Configuration default_configuration() const;
+
         /// IFrameFilter
         virtual bool operator()(const input_pointer& inframe, output_pointer& outframe);
+
+      private:
+        int m_nthreads{1};
+        size_t m_block_size{16};
     };
 
     class CoherentAddNoise : public NoiseBaseT<IGroupSpectrum>,
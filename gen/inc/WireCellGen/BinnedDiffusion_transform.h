@@ -7,13 +7,56 @@
 #include "WireCellIface/IDepo.h"
 
 #include "WireCellGen/ImpactData.h"
+#include "WireCellGen/GaussianDiffusion.h"
+
+#include "WireCellUtil/Array.h"
 
 #include <deque>
-#include <Eigen/Sparse>
+#include <vector>
 
 namespace WireCell {
     namespace Gen {
 
+        /** Charge on a (wire, tick) grid held in dense blocks which
+         * are allocated on first use.  Memory thus follows the area
+         * with activity and not the full grid.
+         */
+        class ChargeBlocks {
+           public:
+            ChargeBlocks(int nwires = 0, int nticks = 0, int wire_block = 16, int tick_block = 256);
+
+            /// Add charge to a cell.  Cells out of the grid are
+            /// ignored and false is returned.
+            bool add(int wire, int tick, float charge)
+            {
+                if (wire < 0 or wire >= m_nwires or tick < 0 or tick >= m_nticks) {
+                    return false;
+                }
+                auto& blk = m_blocks[(wire / m_wire_block) * m_nblock_ticks + tick / m_tick_block];
+                if (blk.empty()) {
+                    blk.resize(m_wire_block * m_tick_block, 0);
+                }
+                blk[(wire % m_wire_block) * m_tick_block + tick % m_tick_block] += charge;
+                return true;
+            }
+
+            /// Return the grid as a dense (wire, tick) array.
+            Array::array_xxf dense() const;
+
+            /// Free all blocks.
+            void clear();
+
+            int nwires() const { return m_nwires; }
+            int nticks() const { return m_nticks; }
+
+            /// Number of bytes held in allocated blocks.
+            size_t nbytes() const;
+
+           private:
+            int m_nwires, m_nticks, m_wire_block, m_tick_block, m_nblock_ticks;
+            std::vector<std::vector<float> > m_blocks;
+        };
+
         /* struct GausDiffTimeCompare{ */
         /* 	bool operator()(const std::shared_ptr<Gen::GaussianDiffusion>& lhs, const
          * std::shared_ptr<Gen::GaussianDiffusion>& rhs) const; */
@@ -80,8 +123,14 @@ namespace WireCell {
             // test ...
             void get_charge_vec(std::vector<std::vector<std::tuple<int, int, double> > >& vec_vec_charge,
                                 std::vector<int>& vec_impact);
-            void get_charge_matrix(std::vector<Eigen::SparseMatrix<float>*>& vec_spmatrix,
-                                   std::vector<int>& vec_impact);
+
+            /// Accumulate the charge of all depos into one grid per
+            /// reduced impact given in vec_impact.  A grid cell
+            /// (wire, tick) holds charge of channel index
+            /// wire + min_wire and tick bin tick + min_tick.
+            void get_charge_matrix(std::vector<ChargeBlocks>& vec_blocks,
+                                   const std::vector<int>& vec_impact,
+                                   int min_wire, int min_tick);
 
             /// Return the range of pitch containing depos out to
             /// given nsigma and without bounds checking.
@@ -101,6 +150,14 @@ namespace WireCell {
 
             double get_nsigma() const { return m_nsigma; };
 
+            /// Take Gaussian bin integrals from a table when
+            /// sampling.  The table must outlive this object.
+            void set_binint_table(GausBinintTable* table) { m_table = table; }
+
+            /// Set the mean count above which fluctuations use the
+            /// normal approximation, see Multinomial.
+            void set_fluctuate_threshold(double threshold) { m_fluctuate_threshold = threshold; }
+
            private:
             const Pimpos& m_pimpos;
             const Binning& m_tbins;
@@ -108,6 +165,8 @@ namespace WireCell {
             double m_nsigma;
             IRandom::pointer m_fluctuate;
             ImpactDataCalculationStrategy m_calcstrat;
+            GausBinintTable* m_table{nullptr};
+            double m_fluctuate_threshold{Multinomial::default_threshold};
 
             // current window set by user.
             std::pair<int, int> m_window;
@@ -3,6 +3,8 @@
 // This is a very dumb implementation as a per depo drifter is doing
 // extra work to keep its output in time order where as we could do
 // better by ignoring order during drifting and do a final sort().
+// When the drifter is a Gen::Drifter its batch mode is used instead
+// which does just that.
 //
 // Further improvements would drift depos as a block and utilize SIMD.
 // See gen-kokkos for smarter smarts.
@@ -14,6 +16,7 @@
 #define WIRECELLGEN_DEPOSETDRIFTER
 
 #include "WireCellIface/IDrifter.h"
+#include "WireCellGen/Drifter.h"
 #include "WireCellIface/IDepoSetFilter.h"
 #include "WireCellIface/INamed.h"
 #include "WireCellIface/IConfigurable.h"
@@ -38,6 +41,9 @@ namespace WireCell::Gen {
       private:
 
         IDrifter::pointer m_drifter{nullptr};
+        // Set if the drifter supports batch mode.
+        std::shared_ptr<Drifter> m_batch{nullptr};
+        int m_nthreads{1};
         size_t m_count{0};
 
     };
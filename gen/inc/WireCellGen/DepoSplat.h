@@ -16,6 +16,7 @@
 #include "WireCellIface/IAnodeFace.h"
 #include "WireCellIface/IAnodePlane.h"
 #include "WireCellIface/IRandom.h"
+#include "WireCellGen/GaussianDiffusion.h"
 #include "WireCellUtil/Logging.h"
 
 #include <vector>
@@ -52,6 +53,11 @@ namespace WireCell {
             // fluctuation to each Gaussian sampling.  Default is no
             // fluctuation.
             IRandom::pointer m_rng;
+            double m_fluctuate_threshold{Multinomial::default_threshold};
+
+            // If set (config patch_lut=true), take Gaussian bin
+            // integrals from this table.
+            std::unique_ptr<GausBinintTable> m_table;
 
             int m_frame_count;
             // if non-empty, set as tag on output frame
@@ -1,10 +1,16 @@
 /** Make a frame from depos using an ImpactTransform.
+
+    The planes of each face are independent and may be transformed
+    concurrently by setting "nthreads".  Subclasses which override
+    modify_depo() must then make it safe to call concurrently.
  */
 
 #ifndef WIRECELLGEN_DEPOTRANSFORM
 #define WIRECELLGEN_DEPOTRANSFORM
 
 #include "WireCellAux/Logger.h"
+#include "WireCellGen/ImpactTransform.h"
+#include "WireCellGen/GaussianDiffusion.h"
 
 #include "WireCellIface/IDepoFramer.h"
 #include "WireCellIface/IConfigurable.h"
@@ -35,6 +41,18 @@ namespace WireCell {
             virtual IDepo::pointer modify_depo(WirePlaneId wpid, IDepo::pointer depo) { return depo; }
 
            private:
+            // The work for one plane of one face.
+            struct PlaneJob {
+                IAnodeFace::pointer face;
+                IWirePlane::pointer plane;
+                int iplane;
+                const IDepo::vector* depos;
+                GausBinintTable* table{nullptr};
+                ITrace::vector traces{};
+            };
+            void run_plane(PlaneJob& job, IRandom::pointer rng);
+            void run_jobs(std::vector<PlaneJob>& jobs);
+
             IAnodePlane::pointer m_anode;
             IRandom::pointer m_rng;
             IDFT::pointer m_dft;
@@ -45,8 +63,18 @@ namespace WireCell {
             double m_tick;
             double m_drift_speed;
             double m_nsigma;
+            double m_fluctuate_threshold{Multinomial::default_threshold};
             int m_frame_count;
             size_t m_count{0};
+            int m_nthreads{1};
+
+            ImpactTransformCache m_cache;
+
+            // Gaussian bin integral tables, one per plane job.
+            bool m_patch_lut{false};
+            double m_patch_lut_precision{0.01};
+            int m_patch_lut_offsets{100};
+            std::vector<std::unique_ptr<GausBinintTable> > m_tables;
 
         };
     }  // namespace Gen
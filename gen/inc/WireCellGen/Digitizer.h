@@ -3,6 +3,15 @@
  * Resulting waveforms are still in floating-point form and should be
  * round()'ed and truncated to whatever integer representation is
  * wanted by some subsequent node.
+ *
+ * The digitize() method taking many samples applies gain, baseline,
+ * clamp and rounding in one pass which the compiler may vectorize.
+ *
+ * ITrace only holds float samples so the output frame can not itself
+ * be int16.  For a compact int16 form follow this node with an
+ * Aux::FrameTensor configured with "digitize": true, which stores
+ * traces as "i2" tensors.  That is exact for a resolution of up to 15
+ * bits.
  */
 
 #ifndef WIRECELL_DIGITIZER
@@ -35,6 +44,11 @@ namespace WireCell::Gen {
         // to the baseline.
         double digitize(double voltage);
 
+        // Digitize n voltages in place, first applying the gain and
+        // adding the baseline.  Result is the same as digitize()
+        // above for each sample.
+        void digitize(float* wave, size_t n, float baseline) const;
+
       private:
         /// Config: "anode" - type/name of an IAnodePlane
         IAnodePlane::pointer m_anode;
@@ -123,6 +123,17 @@ namespace WireCell {
             void flush(output_queue& outq);
             void flush_ripe(output_queue& outq, double now);
 
+            // Batch mode.  Drift a whole set of depos at once and
+            // return all that survive in time order.  Nothing is
+            // buffered between calls and no EOS is needed.  Each
+            // xregion is drifted as a separate job, run on up to
+            // nthreads threads.  If the generator provides substreams
+            // each job has its own keyed by "stream_id", the ident of
+            // the depo set and the xregion so the result does not
+            // depend on nthreads or call order.  Otherwise
+            // fluctuations force a single thread.
+            IDepo::vector drift(const IDepo::vector& depos, int ident, size_t nthreads = 1);
+
             // Reset lifetime e.g. based on a larsoft database.
             // Detailed implementation in a subclass.
             virtual void set_lifetime(double lifetime_to_set) { m_lifetime = lifetime_to_set; };
@@ -163,6 +174,25 @@ namespace WireCell {
             };
             std::vector<Xregion> m_xregions;
 
+            // Return the drifted depo and set its region index or
+            // return nullptr if the depo is dropped.
+            IDepo::pointer drift_one(const input_pointer& depo, size_t& region);
+
+            // Find the region of the depo and the drift direction
+            // (+1 bulk, -1 response) or return false to drop it.
+            bool find_region(const input_pointer& depo, size_t& region, double& direction) const;
+
+            // Drift the depo in the region using the generator.
+            IDepo::pointer drift_in(const input_pointer& depo, const Xregion& xr, double direction,
+                                    IRandom& rng) const;
+
+            // Distinguishes substreams of drifters sharing a generator.
+            int m_stream_id{0};
+
+            // Move depos earlier than now from the region buffers to
+            // the queue, merged in time order.
+            void take_ripe(output_queue& outq, double now);
+
             struct IsInsideBulk {
                 const input_pointer& depo;
                 IsInsideBulk(const input_pointer& depo)
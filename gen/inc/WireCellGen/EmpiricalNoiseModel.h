@@ -21,6 +21,7 @@
 #include "WireCellUtil/Waveform.h"
 #include "WireCellAux/Logger.h"
 
+#include <deque>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -48,6 +49,9 @@ namespace WireCell {
             /// IChannelSpectrum
             virtual const amplitude_t& channel_spectrum(int chid) const;
 
+            /// Number of distinct spectra held for all channels seen so far.
+            size_t nspectra() const;
+
             // get constant term
             virtual const std::vector<float>& freq() const;
             // get json file gain
@@ -109,18 +113,23 @@ namespace WireCell {
 
             std::map<int, std::vector<NoiseSpectrum*> > m_spectral_data;
 
-            // cache amplitudes to the nearest integral distance.
-            mutable std::unordered_map<int, int> m_chid_to_intlen;
-
             typedef std::unordered_map<int, spectrum_data_t> len_amp_cache_t;
             mutable std::vector<len_amp_cache_t> m_len_amp_cache;
 
-            // two layered caching to avoid per-channel cache
-            // chid -> pack-key
-            mutable std::unordered_map<int, unsigned int> m_channel_packkey_cache;
-            using channel_amp_cache_t = std::unordered_map<unsigned int, amplitude_t>;
-            mutable channel_amp_cache_t m_channel_amp_cache;
-            
+            // Bank of distinct channel spectra.  Channels with the same
+            // (plane, length, gain, shaping) key share an entry and
+            // keys giving equal spectra are further merged by content.
+            // A deque keeps references valid as the bank grows.
+            const amplitude_t& bank_spectrum(int chid) const;
+            size_t bank_index(amplitude_t&& amp) const;
+            mutable std::deque<amplitude_t> m_spectrum_bank;
+            // content hash -> bank indices
+            mutable std::unordered_multimap<size_t, size_t> m_bank_hash;
+            // pack-key -> bank index
+            mutable std::unordered_map<unsigned int, size_t> m_packkey_index;
+            // chid -> bank index
+            mutable std::unordered_map<int, size_t> m_chid_index;
+
             // need to convert the electronics response in here ...
             Waveform::realseq_t m_elec_resp_freq;
             mutable std::unordered_map<int, Waveform::realseq_t> m_elec_resp_cache;
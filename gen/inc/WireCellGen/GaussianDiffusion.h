@@ -1,12 +1,14 @@
 #ifndef WIRECELLGEN_GAUSSIANDIFFUSION
 #define WIRECELLGEN_GAUSSIANDIFFUSION
 
+#include "WireCellGen/Multinomial.h"
 #include "WireCellUtil/Array.h"
 #include "WireCellUtil/Binning.h"
 #include "WireCellIface/IDepo.h"
 #include "WireCellIface/IRandom.h"
 
 #include <memory>
+#include <unordered_map>
 
 namespace WireCell {
     namespace Gen {
@@ -62,6 +64,41 @@ namespace WireCell {
             std::vector<double> weight(double start, double step, int nbins, std::vector<double> pvec) const;
         };
 
+        /** A table of Gaussian bin integrals as from GausDesc::binint().
+         *
+         * In units of the bin size, the integrals depend only on the
+         * sigma, the offset of the center from the first bin edge and
+         * the number of bins.  The table quantizes sigma to a relative
+         * precision and the offset to a fraction of a bin and keeps
+         * the integrals of each distinct key.  After drift most depos
+         * share few sigma values and so most lookups avoid erf().
+         *
+         * The result is approximate to the quantization.  A table is
+         * not thread safe and should be used by one thread.
+         */
+        class GausBinintTable {
+           public:
+            /// Sigma is quantized with the given relative precision
+            /// and the offset to 1/noffsets of a bin.  Beyond
+            /// max_entries, integrals are calculated and not kept.
+            GausBinintTable(double sigma_precision = 0.01, int noffsets = 100, size_t max_entries = 100000);
+
+            /// As GausDesc::binint() but possibly from the table.
+            std::vector<double> binint(const GausDesc& gd, double start, double step, int nbins);
+
+            size_t size() const { return m_table.size(); }
+            size_t hits() const { return m_hits; }
+            size_t misses() const { return m_misses; }
+
+           private:
+            double m_log_precision;
+            int m_noffsets;
+            size_t m_max_entries;
+            size_t m_hits{0}, m_misses{0};
+            // key is packed (quantized sigma, quantized offset, nbins)
+            std::unordered_map<uint64_t, std::vector<double> > m_table;
+        };
+
         class GaussianDiffusion {
            public:
             typedef std::shared_ptr<GaussianDiffusion> pointer;
@@ -88,9 +125,14 @@ namespace WireCell {
             /// represents the 2D bin-centered sampling of the
             /// Gaussian.
 
+            /// If a table is given, the Gaussian bin integrals are
+            /// taken from it.  Fluctuations follow a multinomial
+            /// distribution, see Multinomial for the threshold.
             void set_sampling(const Binning& tbin, const Binning& pbin, double nsigma = 3.0,
                               IRandom::pointer fluctuate = nullptr,
-                              unsigned int weightstrat = 1 /*see BinnedDiffusion ImpactDataCalculationStrategy*/);
+                              unsigned int weightstrat = 1 /*see BinnedDiffusion ImpactDataCalculationStrategy*/,
+                              GausBinintTable* table = nullptr,
+                              double fluctuate_threshold = Multinomial::default_threshold);
             void clear_sampling();
 
             /// Get the diffusion patch as an array of N_pitch rows X
@@ -10,9 +10,65 @@
 
 #include <Eigen/Sparse>
 
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
 namespace WireCell {
     namespace Gen {
 
+        /** A cache of the response spectra that ImpactTransform
+         * convolves with charge.
+         *
+         * The spectra depend only on the PIR and on the (wire, tick)
+         * shape of the transform and so they repeat across events,
+         * planes and readouts.  Entries are keyed by PIR instance and
+         * shape and the least recently used are dropped to keep the
+         * total below a capacity in bytes.  All methods may be called
+         * from concurrent threads.
+         */
+        class ImpactTransformCache {
+           public:
+            /// One (wire, tick) spectrum per impact group.
+            using spectra_t = std::vector<Array::array_xxc>;
+            using spectra_ptr = std::shared_ptr<const spectra_t>;
+            using maker_t = std::function<spectra_t()>;
+
+            /// A capacity of zero disables caching.
+            ImpactTransformCache(size_t capacity = 0);
+
+            /// Return the spectra for the PIR and shape, calling
+            /// make() to produce them if not cached.
+            spectra_ptr get(const IPlaneImpactResponse::pointer& pir,
+                            int nwires, int nticks, maker_t make);
+
+            /// Set the capacity in bytes, dropping entries as needed.
+            void set_capacity(size_t capacity);
+
+            size_t capacity() const;
+            size_t nbytes() const;
+            size_t hits() const;
+            size_t misses() const;
+
+           private:
+            using key_t = std::tuple<const IPlaneImpactResponse*, int, int>;
+            struct Entry {
+                IPlaneImpactResponse::pointer pir;  // keeps key address valid
+                spectra_ptr spectra;
+                size_t nbytes;
+                std::list<key_t>::iterator lru;
+            };
+            void shrink(size_t capacity);
+
+            size_t m_capacity, m_nbytes{0}, m_hits{0}, m_misses{0};
+            std::map<key_t, Entry> m_entries;
+            std::list<key_t> m_lru;  // most recent first
+            mutable std::mutex m_mutex;
+        };
+
         /** An ImpactTransform transforms charge on impact positions
          * into waveforms via 2D FFT.
          */
@@ -24,7 +80,6 @@ namespace WireCell {
             int m_num_group;     // how many 2D convolution is needed
             int m_num_pad_wire;  // how many wires are needed to pad on each side
             std::vector<std::map<int, IImpactResponse::pointer> > m_vec_map_resp;
-            std::vector<std::vector<std::tuple<int, int, double> > > m_vec_vec_charge;  // ch, time, charge
             // std::vector<Eigen::SparseMatrix<float>* > m_vec_spmatrix;
 
             std::vector<int> m_vec_impact;
@@ -35,9 +90,12 @@ namespace WireCell {
             int m_end_tick;
 
            public:
+            /// If a cache is given, response spectra are taken from
+            /// it or made and added to it.
             ImpactTransform(IPlaneImpactResponse::pointer pir,
                             const IDFT::pointer& dft,
-                            BinnedDiffusion_transform& bd);
+                            BinnedDiffusion_transform& bd,
+                            ImpactTransformCache* cache = nullptr);
 
             virtual ~ImpactTransform();
 
@@ -52,6 +110,11 @@ namespace WireCell {
 
             // fixme: this should be a forward iterator so that it may cal bd.erase() safely to conserve memory
             Waveform::realseq_t waveform(int wire) const;
+
+           private:
+            // Make the response spectra of the first ngroups impact
+            // groups, transformed in both wire and tick dimensions.
+            ImpactTransformCache::spectra_t response_spectra(int ngroups, int nwires, int nticks) const;
         };
 
     }  // namespace Gen
@@ -0,0 +1,56 @@
+/** Sample a multinomial distribution over many cells.
+
+    This is used to fluctuate the number of electrons falling in each
+    cell of a diffusion patch while preserving their total.  It uses
+    the sequential-conditional method: the count in each cell is
+    binomial given the counts not yet placed and the weight not yet
+    visited.
+
+    Each binomial is sampled exactly by inversion when its mean is at
+    or below the threshold and otherwise by the normal approximation.
+    The generator is accessed through callables made once so no
+    distribution object is constructed per sample.
+
+    A Multinomial is not thread safe.
+ */
+
+#ifndef WIRECELLGEN_MULTINOMIAL
+#define WIRECELLGEN_MULTINOMIAL
+
+#include "WireCellIface/IRandom.h"
+
+#include <cstddef>
+
+namespace WireCell {
+    namespace Gen {
+
+        class Multinomial {
+           public:
+            /// The threshold on the smaller of the binomial mean n*p
+            /// and n*(1-p) above which the normal approximation is
+            /// used.  It is limited to max_threshold to keep exact
+            /// sampling numerically sound.
+            static constexpr double default_threshold = 30.0;
+            static constexpr double max_threshold = 500.0;
+
+            Multinomial(IRandom::pointer rng, double threshold = default_threshold);
+
+            /// Sample one binomial count of n trials with probability p.
+            int binomial(int n, double p);
+
+            /// Distribute ntotal counts over n cells.  On input the
+            /// cells hold non-negative weights which need not be
+            /// normalized.  On output they hold the counts which sum
+            /// to ntotal unless all weights are zero.  Returns the sum.
+            int operator()(int ntotal, float* cells, size_t n);
+
+           private:
+            IRandom::pointer m_rng;
+            IRandom::double_func m_uniform, m_normal;
+            double m_threshold;
+        };
+
+    }  // namespace Gen
+}  // namespace WireCell
+
+#endif
@@ -0,0 +1,108 @@
+/**
+   Gen::PhiloxRandom is an IRandom based on the Philox4x32-10
+   counter-based generator of Salmon et al., "Parallel random
+   numbers: as easy as 1, 2, 3" (SC11).
+
+   The output is a pure function of a 64 bit seed, a 64 bit stream
+   number and a position in the stream.  Substreams are made by
+   hashing their key with the stream number of the parent so that
+   each unit of parallel work (eg per event, anode and channel) may
+   have its own generator and give results which do not depend on
+   the number of threads or the order of their work.
+ */
+
+#ifndef WIRECELLGEN_PHILOXRANDOM
+#define WIRECELLGEN_PHILOXRANDOM
+
+#include "WireCellIface/IRandom.h"
+#include "WireCellIface/IConfigurable.h"
+
+#include <array>
+#include <cstdint>
+
+namespace WireCell {
+    namespace Gen {
+
+        /// The Philox4x32-10 bijection used as a uniform random bit
+        /// generator.  Each call of the block function gives four
+        /// 32 bit words.
+        class Philox {
+           public:
+            using result_type = uint32_t;
+            using counter_type = std::array<uint32_t, 4>;
+            using key_type = std::array<uint32_t, 2>;
+
+            Philox(uint64_t seed = 0, uint64_t stream = 0);
+
+            static constexpr result_type min() { return 0; }
+            static constexpr result_type max() { return 0xffffffff; }
+
+            /// Return the next word.
+            result_type operator()()
+            {
+                if (m_used == 4) {
+                    next_block();
+                }
+                return m_block[m_used++];
+            }
+
+            /// Apply the bijection to one counter.
+            static counter_type block(counter_type ctr, key_type key);
+
+           private:
+            void next_block();
+
+            key_type m_key;
+            counter_type m_ctr;  // low two words count blocks
+            counter_type m_block;
+            int m_used{4};
+        };
+
+        class PhiloxRandom : public IRandom, public IConfigurable {
+           public:
+            PhiloxRandom(uint64_t seed = 0, uint64_t stream = 0);
+            virtual ~PhiloxRandom() {}
+
+            // IConfigurable interface
+            virtual void configure(const WireCell::Configuration& config);
+            virtual WireCell::Configuration default_configuration() const;
+
+            virtual int binomial(int max, double prob);
+            virtual int_func make_binomial(int max, double prob);
+
+            virtual int poisson(double mean);
+            virtual int_func make_poisson(double mean);
+
+            virtual double normal(double mean, double sigma);
+            virtual double_func make_normal(double mean, double sigma);
+
+            virtual double uniform(double begin, double end);
+            virtual double_func make_uniform(double begin, double end);
+
+            virtual double exponential(double mean);
+            virtual double_func make_exponential(double mean);
+
+            virtual int range(int first, int last);
+            virtual int_func make_range(int first, int last);
+
+            virtual void fill_normal(float* out, size_t n, double mean = 0.0, double sigma = 1.0);
+            virtual void fill_uniform(float* out, size_t n, double begin = 0.0, double end = 1.0);
+
+            virtual IRandom::pointer substream(const std::vector<uint64_t>& key) const;
+
+            /// The stream number of the substream with the key.
+            static uint64_t stream_number(uint64_t stream, const std::vector<uint64_t>& key);
+
+           private:
+            uint64_t m_seed, m_stream;
+            Philox m_engine;
+            // Box-Muller gives normal values in pairs.
+            bool m_have_normal{false};
+            double m_normal{0};
+
+            double unit_open();  // in (0,1]
+        };
+
+    }  // namespace Gen
+}  // namespace WireCell
+#endif
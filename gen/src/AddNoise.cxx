@@ -7,7 +7,9 @@
 #include "WireCellAux/SimpleFrame.h"
 #include "WireCellAux/FrameTools.h"
 
+#include "WireCellUtil/Parallel.h"
 
+#include <algorithm>
 #include <unordered_map>
 
 WIRECELL_FACTORY(IncoherentAddNoise, WireCell::Gen::IncoherentAddNoise,
@@ -34,6 +36,34 @@ Gen::IncoherentAddNoise::IncoherentAddNoise()
 }
 Gen::IncoherentAddNoise::~IncoherentAddNoise() {}
 
+WireCell::Configuration Gen::IncoherentAddNoise::default_configuration() const
+{
+    auto cfg = NoiseBaseT<IChannelSpectrum>::default_configuration();
+    // Number of threads with which to transform blocks of traces.
+    cfg["nthreads"] = m_nthreads;
+    // Number of traces transformed together by one batched DFT.
+    cfg["block_size"] = (unsigned int) m_block_size;
+    return cfg;
+}
+
+void Gen::IncoherentAddNoise::configure(const WireCell::Configuration& cfg)
+{
+    NoiseBaseT<IChannelSpectrum>::configure(cfg);
+    m_nthreads = std::max(1, get<int>(cfg, "nthreads", m_nthreads));
+    m_block_size = std::max(1, get<int>(cfg, "block_size", m_block_size));
+}
+
+namespace {
+    // Add a noise wave to the charge, truncating the longer.
+    void add_wave(ITrace::ChargeSequence& charge, const float* wave, size_t nwave)
+    {
+        const size_t n = std::min(nwave, charge.size());
+        for (size_t ind = 0; ind < n; ++ind) {
+            charge[ind] += wave[ind];
+        }
+    }
+}
+
 Gen::CoherentAddNoise::CoherentAddNoise()
     : Gen::NoiseBaseT<IGroupSpectrum>("CoherentAddNoise")
 {
@@ -62,56 +92,93 @@ bool Gen::IncoherentAddNoise::operator()(const input_pointer& inframe, output_po
     static bool warned = false;
     static bool warned2 = false;
 
-    // Make waveforms of size nsample from each model, adding only
-    // ncharge of their element to the trace charge.  This
-    // full-nsample followed by ncharge-truncation may CPU-wasteful in
-    // the sparse traces case.
-
     const float sqrt2opi = sqrt(2.0/3.141592);
 
-    ITrace::vector outtraces;
-    for (const auto& intrace : *inframe->traces()) {
+    const auto& intraces = *inframe->traces();
+    const size_t ntraces = intraces.size();
+    std::vector<ITrace::ChargeSequence> charges(ntraces);
+    for (size_t itrace = 0; itrace < ntraces; ++itrace) {
+        charges[itrace] = intraces[itrace]->charge(); // copies
+        if (not warned2 and m_nsamples < charges[itrace].size()) {
+            log->warn("undersized noise {} for input waveform {}, future warnings muted",
+                      m_nsamples, charges[itrace].size());
+            warned2 = true;
+        }
+    }
 
-        const int chid = intrace->channel();
-        auto charge = intrace->charge(); // copies
-        const size_t ncharge = charge.size();
+    // Traces are processed in chunks of one block per thread.  The
+    // half spectra of a chunk are summed over models serially, to
+    // keep the random sequence, and then each block is transformed
+    // and added to its traces.
+    const size_t nsamples = m_nsamples;
+    const size_t nhalf = nsamples / 2 + 1;
+    const size_t nblock = m_block_size;
+    const size_t nchunk = nblock * m_nthreads;
+    complex_vector_t halves(std::min(nchunk, ntraces) * nhalf);
+    real_vector_t waves(std::min(nchunk, ntraces) * nsamples);
+    real_vector_t sigmas;
+
+    auto do_block = [&](size_t chunk0, size_t row0, size_t nrows) {
+        m_dft->inv1b_c2r(halves.data() + row0 * nhalf, waves.data() + row0 * nsamples,
+                         nrows, nsamples, 1);
+        for (size_t row = row0; row < row0 + nrows; ++row) {
+            add_wave(charges[chunk0 + row], waves.data() + row * nsamples, nsamples);
+        }
+    };
 
-        for (auto& [mtn, model] : m_models) {
-            const auto& spec = model->channel_spectrum(chid);
-            const size_t nspec = spec.size();
+    for (size_t chunk0 = 0; chunk0 < ntraces; chunk0 += nchunk) {
+        const size_t nrows = std::min(nchunk, ntraces - chunk0);
+        std::fill(halves.begin(), halves.begin() + nrows * nhalf, 0);
 
-            if (! nspec) {
-                continue;       // channel not in model
-            }
+        for (size_t row = 0; row < nrows; ++row) {
+            const size_t itrace = chunk0 + row;
+            const int chid = intraces[itrace]->channel();
 
-            // The model spec size may differ than expected nsamples.
-            // We could interpolate to correct for that which would
-            // slow things down.  Better to correct the model(s) code
-            // and configuration.
-            if (not warned and nspec != m_nsamples) {
-                log->warn("model {} produced {} samples instead of expected {}, future warnings muted",
-                          mtn, nspec, m_nsamples);
-                warned = true;
-            }
+            for (auto& [mtn, model] : m_models) {
+                const auto spec = model->channel_spectrum_span(chid);
+                const size_t nspec = spec.size();
 
-            const size_t nsigmas = nspec;
-            // const nsigmas = m_nsamples;
-            real_vector_t sigmas(nsigmas);
-            for (size_t ind=0; ind < nsigmas; ++ind) {
-                sigmas[ind] = spec[ind]*sqrt2opi;
-            }
+                if (! nspec) {
+                    continue;       // channel not in model
+                }
 
-            auto wave = rwgen.wave(sigmas);
-            if (not warned2 and wave.size() < ncharge) {
-                log->warn("undersized noise {} for input waveform {}, future warnings muted", wave.size(), ncharge);
-                warned2 = true;
-            }
-            wave.resize(ncharge);
-            Waveform::increase(charge, wave);
+                // The model spec size may differ than expected nsamples.
+                // We could interpolate to correct for that which would
+                // slow things down.  Better to correct the model(s) code
+                // and configuration.
+                if (not warned and nspec != m_nsamples) {
+                    log->warn("model {} produced {} samples instead of expected {}, future warnings muted",
+                              mtn, nspec, m_nsamples);
+                    warned = true;
+                }
+
+                sigmas.resize(nspec);
+                for (size_t ind=0; ind < nspec; ++ind) {
+                    sigmas[ind] = spec[ind]*sqrt2opi;
+                }
 
+                if (nspec != nsamples) {
+                    // Can not join the batch so transform it alone.
+                    auto wave = rwgen.wave(sigmas);
+                    add_wave(charges[itrace], wave.data(), wave.size());
+                    continue;
+                }
+                rwgen.add_half_spec(sigmas, halves.data() + row * nhalf);
+            }
         }
 
-        auto trace = make_shared<SimpleTrace>(chid, intrace->tbin(), charge);
+        const size_t nblocks = (nrows + nblock - 1) / nblock;
+        parallel_for(nblocks, [&](size_t iblock) {
+            const size_t row0 = iblock * nblock;
+            do_block(chunk0, row0, std::min(nblock, nrows - row0));
+        }, m_nthreads);
+    }
+
+    ITrace::vector outtraces;
+    outtraces.reserve(ntraces);
+    for (size_t itrace = 0; itrace < ntraces; ++itrace) {
+        const auto& intrace = intraces[itrace];
+        auto trace = make_shared<SimpleTrace>(intrace->channel(), intrace->tbin(), charges[itrace]);
         outtraces.push_back(trace);
     }
     outframe = make_shared<SimpleFrame>(inframe->ident(), inframe->time(), outtraces, inframe->tick());
@@ -142,57 +209,74 @@ bool Gen::CoherentAddNoise::operator()(const input_pointer& inframe, output_poin
     auto rn = Normals::make_recycling(m_rng, 2*m_nsamples, BUG, 1, 2*m_rep_percent);
     GeneratorN rwgen(m_dft, rn);
 
-    // Look up the generated wave for a group.
-    using group_wave_lu = std::unordered_map<int, real_vector_t>;
+    // Look up the row of the generated waves for a group.
+    using group_row_lu = std::unordered_map<int, size_t>;
     // Models may not be coherent across their groups so we have a LU
     // per model.
-    std::unordered_map<std::string, group_wave_lu> model_group_waves;
+    std::unordered_map<std::string, group_row_lu> model_group_rows;
 
     // Limit number of warnings below
     static bool warned = false;
 
     const float sqrt2opi = sqrt(2.0/3.141592);
 
-    // Make waveforms of size nsample from each model, adding only
-    // ncharge of their element to the trace charge.  This
-    // full-nsample followed by ncharge-truncation may CPU-wasteful in
-    // the sparse traces case.
+    const size_t nsamples = m_nsamples;
+    const size_t nhalf = nsamples / 2 + 1;
+
+    // Make the half spectra of each group in the order they are first
+    // seen by the traces and then transform them all in one batch.
+    complex_vector_t halves;
+    real_vector_t sigmas(nsamples);
+    size_t nrows = 0;
+    for (const auto& intrace : *inframe->traces()) {
+        const int chid = intrace->channel();
+        for (auto& [mtn, model] : m_models) {
+            auto& grlu = model_group_rows[mtn];
+            int grpid = model->groupid(chid);
+            if (grlu.find(grpid) != grlu.end()) {
+                continue;
+            }
+            const auto& spec = model->group_spectrum(grpid);
+            if (spec.empty()) {
+                continue;       // channel not in model
+            }
+
+            // The model spec size may differ than expected nsamples.
+            // We could interpolate to correct for that which would
+            // slow things down.  Better to correct the model(s) code
+            // and configuration.
+            if (not warned and spec.size() != m_nsamples) {
+                log->warn("model {} produced {} samples instead of expected {}, future warnings muted",
+                          mtn, spec.size(), m_nsamples);
+                warned = true;
+            }
+            for (size_t ind=0; ind<nsamples; ++ind) {
+                sigmas[ind] = ind < spec.size() ? spec[ind]*sqrt2opi : 0;
+            }
+            halves.resize((nrows + 1) * nhalf, 0);
+            rwgen.add_half_spec(sigmas, halves.data() + nrows * nhalf);
+            grlu[grpid] = nrows++;
+        }
+    }
+
+    real_vector_t waves(nrows * nsamples);
+    if (nrows) {
+        m_dft->inv1b_c2r(halves.data(), waves.data(), nrows, nsamples, 1);
+    }
 
     ITrace::vector outtraces;
     for (const auto& intrace : *inframe->traces()) {
 
         const int chid = intrace->channel();
         auto charge = intrace->charge(); // copies
-        const size_t ncharge = charge.size();
 
         for (auto& [mtn, model] : m_models) {
-            auto& gwlu = model_group_waves[mtn];
-            int grpid = model->groupid(chid);
-            if (gwlu.find(grpid) == gwlu.end()) {
-                const auto& spec = model->group_spectrum(grpid);
-                
-                if (spec.empty()) {
-                    continue;       // channel not in model
-                }
-
-                // The model spec size may differ than expected nsamples.
-                // We could interpolate to correct for that which would
-                // slow things down.  Better to correct the model(s) code
-                // and configuration.
-                if (not warned and spec.size() != m_nsamples) {
-                    log->warn("model {} produced {} samples instead of expected {}, future warnings muted",
-                              mtn, spec.size(), m_nsamples);
-                    warned = true;
-                }
-                real_vector_t sigmas(m_nsamples);
-                for (size_t ind=0; ind<m_nsamples; ++ind) {
-                    sigmas[ind] = spec[ind]*sqrt2opi;
-                }
-                auto wave = rwgen.wave(sigmas);
-                wave.resize(ncharge);
-                gwlu[grpid] = wave;
+            const auto& grlu = model_group_rows[mtn];
+            auto it = grlu.find(model->groupid(chid));
+            if (it == grlu.end()) {
+                continue;
             }
-            Waveform::increase(charge, gwlu[grpid]);
+            add_wave(charge, waves.data() + it->second * nsamples, nsamples);
         }
 
         auto trace = make_shared<SimpleTrace>(chid, intrace->tbin(), charge);
@@ -206,4 +290,3 @@ bool Gen::CoherentAddNoise::operator()(const input_pointer& inframe, output_poin
     ++m_count;
     return true;
 }
-
@@ -20,6 +20,54 @@ using namespace WireCell;
 //   return lhs->depo_time() < rhs->depo_time();
 // }
 
+Gen::ChargeBlocks::ChargeBlocks(int nwires, int nticks, int wire_block, int tick_block)
+  : m_nwires(nwires)
+  , m_nticks(nticks)
+  , m_wire_block(wire_block)
+  , m_tick_block(tick_block)
+  , m_nblock_ticks((nticks + tick_block - 1) / tick_block)
+  , m_blocks(((nwires + wire_block - 1) / wire_block) * m_nblock_ticks)
+{
+}
+
+Array::array_xxf Gen::ChargeBlocks::dense() const
+{
+    Array::array_xxf arr = Array::array_xxf::Zero(m_nwires, m_nticks);
+    for (size_t ind = 0; ind < m_blocks.size(); ++ind) {
+        const auto& blk = m_blocks[ind];
+        if (blk.empty()) {
+            continue;
+        }
+        const int wire0 = (ind / m_nblock_ticks) * m_wire_block;
+        const int tick0 = (ind % m_nblock_ticks) * m_tick_block;
+        const int nw = std::min(m_wire_block, m_nwires - wire0);
+        const int nt = std::min(m_tick_block, m_nticks - tick0);
+        for (int iw = 0; iw < nw; ++iw) {
+            const float* row = blk.data() + iw * m_tick_block;
+            for (int it = 0; it < nt; ++it) {
+                arr(wire0 + iw, tick0 + it) = row[it];
+            }
+        }
+    }
+    return arr;
+}
+
+void Gen::ChargeBlocks::clear()
+{
+    for (auto& blk : m_blocks) {
+        std::vector<float>().swap(blk);
+    }
+}
+
+size_t Gen::ChargeBlocks::nbytes() const
+{
+    size_t n = 0;
+    for (const auto& blk : m_blocks) {
+        n += blk.size() * sizeof(float);
+    }
+    return n;
+}
+
 Gen::BinnedDiffusion_transform::BinnedDiffusion_transform(const Pimpos& pimpos, const Binning& tbins, double nsigma,
                                                           IRandom::pointer fluctuate,
                                                           ImpactDataCalculationStrategy calcstrat)
@@ -123,48 +171,46 @@ bool Gen::BinnedDiffusion_transform::add(IDepo::pointer depo, double sigma_time,
 //     }
 // }
 
-void Gen::BinnedDiffusion_transform::get_charge_matrix(std::vector<Eigen::SparseMatrix<float>*>& vec_spmatrix,
-                                                       std::vector<int>& vec_impact)
+void Gen::BinnedDiffusion_transform::get_charge_matrix(std::vector<ChargeBlocks>& vec_blocks,
+                                                       const std::vector<int>& vec_impact,
+                                                       int min_wire, int min_tick)
 {
     const auto ib = m_pimpos.impact_binning();
+    const auto rb = m_pimpos.region_binning();
 
     // map between reduced impact # to array #
     std::map<int, int> map_redimp_vec;
     for (size_t i = 0; i != vec_impact.size(); i++) {
         map_redimp_vec[vec_impact[i]] = int(i);
     }
-
-    const auto rb = m_pimpos.region_binning();
-    // map between impact # to channel #
-    std::map<int, int> map_imp_ch;
-    // map between impact # to reduced impact #
-    std::map<int, int> map_imp_redimp;
-
-    // std::cout << ib.nbins() << " " << rb.nbins() << std::endl;
+    // As in get_charge_vec(), an unknown reduced impact goes to array 0.
+    auto array_num = [&](int redimp) {
+        auto it = map_redimp_vec.find(redimp);
+        return it == map_redimp_vec.end() ? 0 : it->second;
+    };
+
+    // Per impact #, the channel and the arrays taking the charge
+    // below and above the impact.
+    const int nimps = ib.nbins();
+    std::vector<int> imp_ch(nimps, 0), imp_array(nimps, array_num(0)), imp_next_array(nimps, array_num(1));
     for (int wireind = 0; wireind != rb.nbins(); wireind++) {
         int wire_imp_no = m_pimpos.wire_impact(wireind);
         std::pair<int, int> imps_range = m_pimpos.wire_impacts(wireind);
         for (int imp_no = imps_range.first; imp_no != imps_range.second; imp_no++) {
-            map_imp_ch[imp_no] = wireind;
-            map_imp_redimp[imp_no] = imp_no - wire_imp_no;
-
-            //  std::cout << imp_no << " " << wireind << " " << wire_imp_no << " " << ib.center(imp_no) << " " <<
-            //  rb.center(wireind) << " " <<  ib.center(imp_no) - rb.center(wireind) << std::endl;
-            // std::cout << imp_no << " " << map_imp_ch[imp_no] << " " << map_imp_redimp[imp_no] << std::endl;
+            if (imp_no < 0 or imp_no >= nimps) continue;
+            const int redimp = imp_no - wire_imp_no;
+            imp_ch[imp_no] = wireind;
+            imp_array[imp_no] = array_num(redimp);
+            imp_next_array[imp_no] = array_num(redimp + 1);
         }
     }
 
-    int min_imp = 0;
-    int max_imp = ib.nbins();
-
     for (auto diff : m_diffs) {
-        //    std::cout << diff->depo()->time() << std::endl
-        // diff->set_sampling(m_tbins, ib, m_nsigma, 0, m_calcstrat);
-        diff->set_sampling(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat);
-        // counter ++;
+        diff->set_sampling(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat, m_table,
+                           m_fluctuate_threshold);
 
-        const auto patch = diff->patch();
-        const auto qweight = diff->weights();
+        const auto& patch = diff->patch();
+        const auto& qweight = diff->weights();
 
         const int poffset_bin = diff->poffset_bin();
         const int toffset_bin = diff->toffset_bin();
@@ -174,52 +220,21 @@ void Gen::BinnedDiffusion_transform::get_charge_matrix(std::vector<Eigen::Sparse
 
         for (int pbin = 0; pbin != np; pbin++) {
             int abs_pbin = pbin + poffset_bin;
-            if (abs_pbin < min_imp || abs_pbin >= max_imp) continue;
-            double weight = qweight[pbin];
+            if (abs_pbin < 0 || abs_pbin >= nimps) continue;
+            const double weight = qweight[pbin];
+            const int wire = imp_ch[abs_pbin] - min_wire;
+            auto& blocks = vec_blocks.at(imp_array[abs_pbin]);
+            auto& next_blocks = vec_blocks.at(imp_next_array[abs_pbin]);
 
             for (int tbin = 0; tbin != nt; tbin++) {
-                int abs_tbin = tbin + toffset_bin;
-                double charge = patch(pbin, tbin);
-
-                // std::cout << map_redimp_vec[map_imp_redimp[abs_pbin] ] << " " <<
-                // map_redimp_vec[map_imp_redimp[abs_pbin]+1] << " " << abs_tbin << " " << map_imp_ch[abs_pbin] <<
-                // std::endl;
-
-                vec_spmatrix.at(map_redimp_vec[map_imp_redimp[abs_pbin]])->coeffRef(abs_tbin, map_imp_ch[abs_pbin]) +=
-                    charge * weight;
-                vec_spmatrix.at(map_redimp_vec[map_imp_redimp[abs_pbin] + 1])
-                    ->coeffRef(abs_tbin, map_imp_ch[abs_pbin]) += charge * (1 - weight);
-
-                // if
-                // (map_tuple_pos.find(std::make_tuple(map_redimp_vec[map_imp_redimp[abs_pbin]],map_imp_ch[abs_pbin],abs_tbin))==map_tuple_pos.end()){
-                //   map_tuple_pos[std::make_tuple(map_redimp_vec[map_imp_redimp[abs_pbin]],map_imp_ch[abs_pbin],abs_tbin)]
-                //   = vec_vec_charge.at(map_redimp_vec[map_imp_redimp[abs_pbin] ]).size();
-                //   vec_vec_charge.at(map_redimp_vec[map_imp_redimp[abs_pbin]
-                //   ]).push_back(std::make_tuple(map_imp_ch[abs_pbin],abs_tbin,charge*weight));
-                // }else{
-                //   std::get<2>(vec_vec_charge.at(map_redimp_vec[map_imp_redimp[abs_pbin]
-                //   ]).at(map_tuple_pos[std::make_tuple(map_redimp_vec[map_imp_redimp[abs_pbin]],map_imp_ch[abs_pbin],abs_tbin)]))
-                //   += charge * weight;
-                // }
-
-                // if
-                // (map_tuple_pos.find(std::make_tuple(map_redimp_vec[map_imp_redimp[abs_pbin]+1],map_imp_ch[abs_pbin],abs_tbin))==map_tuple_pos.end()){
-                //   map_tuple_pos[std::make_tuple(map_redimp_vec[map_imp_redimp[abs_pbin]+1],map_imp_ch[abs_pbin],abs_tbin)]
-                //   = vec_vec_charge.at(map_redimp_vec[map_imp_redimp[abs_pbin]+1]).size();
-                //   vec_vec_charge.at(map_redimp_vec[map_imp_redimp[abs_pbin]+1]).push_back(std::make_tuple(map_imp_ch[abs_pbin],abs_tbin,charge*(1-weight)));
-                // }else{
-                //   std::get<2>(vec_vec_charge.at(map_redimp_vec[map_imp_redimp[abs_pbin]+1]).at(map_tuple_pos[std::make_tuple(map_redimp_vec[map_imp_redimp[abs_pbin]+1],map_imp_ch[abs_pbin],abs_tbin)])
-                //   ) += charge*(1-weight);
-                // }
+                const int tick = tbin + toffset_bin - min_tick;
+                const double charge = patch(pbin, tbin);
+                blocks.add(wire, tick, charge * weight);
+                next_blocks.add(wire, tick, charge * (1 - weight));
             }
         }
 
         diff->clear_sampling();
-        // need to figure out wire #, time #, charge, and weight ...
-    }
-
-    for (auto it = vec_spmatrix.begin(); it != vec_spmatrix.end(); it++) {
-        (*it)->makeCompressed();
     }
 }
 
@@ -279,7 +294,8 @@ void Gen::BinnedDiffusion_transform::get_charge_vec(
     for (auto diff : m_diffs) {
         //    std::cout << diff->depo()->time() << std::endl
         // diff->set_sampling(m_tbins, ib, m_nsigma, 0, m_calcstrat);
-        diff->set_sampling(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat);
+        diff->set_sampling(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat, m_table,
+                           m_fluctuate_threshold);
         counter++;
 
         const auto patch = diff->patch();
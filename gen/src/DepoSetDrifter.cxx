@@ -1,6 +1,10 @@
 #include "WireCellGen/DepoSetDrifter.h"
 #include "WireCellUtil/NamedFactory.h"
 #include "WireCellAux/SimpleDepoSet.h"
+#include "WireCellAux/ColumnarDepoSet.h"
+
+#include <algorithm>
+#include <unordered_map>
 
 WIRECELL_FACTORY(DepoSetDrifter, WireCell::Gen::DepoSetDrifter,
                  WireCell::INamed,
@@ -23,6 +27,9 @@ WireCell::Configuration DepoSetDrifter::default_configuration() const
     Configuration cfg;
     // The typename of the drifter to do the real work.
     cfg["drifter"] = "Drifter";
+    // Number of threads drifting xregions in parallel.  This only
+    // applies when the drifter is a Gen::Drifter.
+    cfg["nthreads"] = (int) m_nthreads;
     return cfg;
 }
 
@@ -30,6 +37,33 @@ void DepoSetDrifter::configure(const WireCell::Configuration& cfg)
 {
     auto name = get<std::string>(cfg, "drifter", "Drifter");
     m_drifter = Factory::find_tn<IDrifter>(name);
+    // Our own drifter can take the whole set at once.
+    m_batch = std::dynamic_pointer_cast<Drifter>(m_drifter);
+    m_nthreads = std::max(get<int>(cfg, "nthreads", m_nthreads), 1);
+}
+
+// Make a columnar output with the input rows kept as priors.  Return
+// nullptr if some drifted depo does not have an input depo as prior.
+static IDepoSet::pointer columnar_output(int ident, const IDepoSet::pointer& in, const IDepo::vector& drifted)
+{
+    const auto& in_cols = *in->columns();
+    const auto in_depos = in->depos();
+    std::unordered_map<const IDepo*, int> in_rows;
+    for (size_t ind = 0; ind < in_depos->size(); ++ind) {
+        in_rows[in_depos->at(ind).get()] = in_cols.active[ind];
+    }
+
+    DepoColumns cols;
+    const int offset = drifted.size();
+    for (const auto& depo : drifted) {
+        auto it = in_rows.find(depo->prior().get());
+        if (it == in_rows.end()) {
+            return nullptr;
+        }
+        cols.active.push_back(Aux::append(cols, *depo, offset + it->second));
+    }
+    Aux::append(cols, in_cols);
+    return std::make_shared<Aux::ColumnarDepoSet>(ident, std::move(cols));
 }
 
 bool DepoSetDrifter::operator()(const input_pointer& in, output_pointer& out)
@@ -40,33 +74,50 @@ bool DepoSetDrifter::operator()(const input_pointer& in, output_pointer& out)
         return true;
     }
 
-    // make a copy so we can append an EOS to flush the per depo
-    // drifter.
-    IDepo::vector in_depos(in->depos()->begin(), in->depos()->end());
-    in_depos.push_back(nullptr); // input EOS
-
     double charge_in = 0, charge_out=0;
     IDepo::vector all_depos;
-    for (auto idepo : in_depos) {
-        IDrifter::output_queue more;        
-        (*m_drifter)(idepo, more);
-        all_depos.insert(all_depos.end(), more.begin(), more.end());
-
-        if (idepo) {
+    if (m_batch) {
+        const auto& in_depos = *in->depos();
+        for (const auto& idepo : in_depos) {
             charge_in += idepo->charge();
         }
-        for (const auto& d : more) {
-            if (d) {
-                charge_out += d->charge();
+        all_depos = m_batch->drift(in_depos, in->ident(), m_nthreads);
+        for (const auto& d : all_depos) {
+            charge_out += d->charge();
+        }
+    }
+    else {
+        auto drift = [&](const IDepo::pointer& idepo) {
+            IDrifter::output_queue more;
+            (*m_drifter)(idepo, more);
+            all_depos.insert(all_depos.end(), more.begin(), more.end());
+
+            if (idepo) {
+                charge_in += idepo->charge();
             }
+            for (const auto& d : more) {
+                if (d) {
+                    charge_out += d->charge();
+                }
+            }
+        };
+        for (const auto& idepo : *in->depos()) {
+            drift(idepo);
         }
+        drift(nullptr);         // flush the per depo drifter
+        // The EOS comes through
+        all_depos.pop_back();
     }
-    // The EOS comes through
-    all_depos.pop_back();
         
     log->debug("call={} drifted ndepos={} Qout={} ({}%)", m_count, all_depos.size(), charge_out, 100.0*charge_out/charge_in);
-    out = std::make_shared<Aux::SimpleDepoSet>(m_count, all_depos);
+    if (in->columns()) {
+        // Columnar in, columnar out so the per depo objects made by
+        // the drifter do not outlive this call.
+        out = columnar_output(m_count, in, all_depos);
+    }
+    if (!out) {
+        out = std::make_shared<Aux::SimpleDepoSet>(m_count, all_depos);
+    }
     ++m_count;
     return true;
 }
-
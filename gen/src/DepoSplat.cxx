@@ -77,6 +77,16 @@ WireCell::Configuration Gen::DepoSplat::default_configuration() const
     /// Name of component providing the anode plane.
     put(cfg, "anode", m_anode_tn);
 
+    /// If true, take Gaussian bin integrals from a table, see
+    /// DepoTransform for these options.
+    put(cfg, "patch_lut", false);
+    put(cfg, "patch_lut_precision", 0.01);
+    put(cfg, "patch_lut_offsets", 100);
+
+    /// When fluctuating, the mean count above which a normal
+    /// approximation is used, see DepoTransform.
+    put(cfg, "fluctuate_threshold", m_fluctuate_threshold);
+
     // Tag to apply to output frame if non-empty.
     cfg["frame_tag"] = "";
 
@@ -105,6 +115,7 @@ void Gen::DepoSplat::configure(const WireCell::Configuration& cfg)
         auto tn = get<std::string>(cfg, "rng", "Random");
         m_rng = Factory::find_tn<IRandom>(tn);
     }
+    m_fluctuate_threshold = get<double>(cfg, "fluctuate_threshold", m_fluctuate_threshold);
 
     m_readout_time = get<double>(cfg, "readout_time", m_readout_time);
     m_tick = get<double>(cfg, "tick", m_tick);
@@ -114,6 +125,12 @@ void Gen::DepoSplat::configure(const WireCell::Configuration& cfg)
 
     m_frame_tag = get<std::string>(cfg, "frame_tag", "");
 
+    m_table = nullptr;
+    if (get<bool>(cfg, "patch_lut", false)) {
+        m_table = std::make_unique<GausBinintTable>(get<double>(cfg, "patch_lut_precision", 0.01),
+                                                    get<int>(cfg, "patch_lut_offsets", 100));
+    }
+
     l->debug("DepoSplat: tagging {}, AnodePlane: {}, mode: {}, time start: {} ms, readout time: {} ms, frame start: {}, fluctuate: {}",
              m_frame_tag,
              m_anode_tn, m_mode, m_start_time / units::ms, m_readout_time / units::ms,
@@ -333,7 +350,7 @@ ITrace::vector Gen::DepoSplat::process_face(IAnodeFace::pointer face, const IDep
             Gen::GausDesc pitch_desc(pcen, psig);
 
             auto gd = std::make_shared<Gen::GaussianDiffusion>(depo, time_desc, pitch_desc);
-            gd->set_sampling(tbins, wbins, m_nsigma, m_rng, 1);
+            gd->set_sampling(tbins, wbins, m_nsigma, m_rng, 1, m_table.get(), m_fluctuate_threshold);
             const auto patch = gd->patch();
 
             // std::stringstream ss;
@@ -51,6 +51,10 @@
 #include "WireCellUtil/Units.h"
 #include "WireCellUtil/Point.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Parallel.h"
+#include "WireCellUtil/String.h"
+
+#include <mutex>
 
 
 WIRECELL_FACTORY(DepoTransform, WireCell::Gen::DepoTransform, WireCell::IDepoFramer, WireCell::IConfigurable)
@@ -68,17 +72,138 @@ Gen::DepoTransform::DepoTransform()
   , m_drift_speed(1.0 * units::mm / units::us)
   , m_nsigma(3.0)
   , m_frame_count(0)
+  , m_cache(256 * 1024 * 1024)
 {
 }
 
 Gen::DepoTransform::~DepoTransform() {}
 
+namespace {
+    // Serialize access to an IRandom shared by concurrent planes.
+    class LockedRandom : public IRandom {
+        IRandom::pointer m_rng;
+        std::mutex m_mutex;
+
+       public:
+        LockedRandom(IRandom::pointer rng)
+          : m_rng(rng)
+        {
+        }
+        virtual ~LockedRandom() {}
+        virtual int binomial(int max, double prob)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rng->binomial(max, prob);
+        }
+        virtual int poisson(double mean)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rng->poisson(mean);
+        }
+        virtual double normal(double mean, double sigma)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rng->normal(mean, sigma);
+        }
+        virtual double uniform(double begin, double end)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rng->uniform(begin, end);
+        }
+        virtual double exponential(double mean)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rng->exponential(mean);
+        }
+        virtual int range(int first, int last)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rng->range(first, last);
+        }
+        virtual void fill_normal(float* out, size_t n, double mean, double sigma)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rng->fill_normal(out, n, mean, sigma);
+        }
+        virtual void fill_uniform(float* out, size_t n, double begin, double end)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rng->fill_uniform(out, n, begin, end);
+        }
+    };
+}
+
+void Gen::DepoTransform::run_plane(PlaneJob& job, IRandom::pointer rng)
+{
+    const Pimpos* pimpos = job.plane->pimpos();
+
+    Binning tbins(m_readout_time / m_tick, m_start_time, m_start_time + m_readout_time);
+
+    Gen::BinnedDiffusion_transform bindiff(*pimpos, tbins, m_nsigma, rng);
+    bindiff.set_binint_table(job.table);
+    bindiff.set_fluctuate_threshold(m_fluctuate_threshold);
+    for (auto depo : *job.depos) {
+        depo = modify_depo(job.plane->planeid(), depo);
+        bindiff.add(depo, depo->extent_long() / m_drift_speed, depo->extent_tran());
+    }
+
+    auto& wires = job.plane->wires();
+
+    auto pir = m_pirs.at(job.iplane);
+    Gen::ImpactTransform transform(pir, m_dft, bindiff, &m_cache);
+
+    const int nwires = pimpos->region_binning().nbins();
+    for (int iwire = 0; iwire < nwires; ++iwire) {
+        auto wave = transform.waveform(iwire);
+
+        auto mm = Waveform::edge(wave);
+        if (mm.first == (int) wave.size()) {  // all zero
+            continue;
+        }
+
+        int chid = wires[iwire]->channel();
+        int tbin = mm.first;
+
+        ITrace::ChargeSequence charge(wave.begin() + mm.first, wave.begin() + mm.second);
+        auto trace = make_shared<SimpleTrace>(chid, tbin, charge);
+        job.traces.push_back(trace);
+    }
+}
+
+void Gen::DepoTransform::run_jobs(std::vector<PlaneJob>& jobs)
+{
+    const size_t nthreads = std::min((size_t) m_nthreads, jobs.size());
+
+    // Prefer a substream per plane so that fluctuations do not
+    // depend on the number of threads.
+    std::vector<IRandom::pointer> rngs(jobs.size(), m_rng);
+    if (m_rng) {
+        for (size_t ind = 0; ind < jobs.size(); ++ind) {
+            const auto& job = jobs[ind];
+            auto sub = m_rng->substream({(uint64_t) m_frame_count, (uint64_t) m_anode->ident(),
+                                         (uint64_t) job.face->ident(), (uint64_t) job.iplane});
+            if (!sub) {
+                rngs.assign(jobs.size(), m_rng);
+                break;
+            }
+            rngs[ind] = sub;
+        }
+    }
+
+    if (nthreads > 1 and m_rng and rngs[0] == m_rng) {
+        rngs.assign(jobs.size(), std::make_shared<LockedRandom>(m_rng));
+    }
+
+    parallel_for(jobs.size(), [&](size_t ind) { run_plane(jobs[ind], rngs[ind]); }, nthreads);
+}
+
 void Gen::DepoTransform::configure(const WireCell::Configuration& cfg)
 {
     auto anode_tn = get<string>(cfg, "anode", "");
     m_anode = Factory::find_tn<IAnodePlane>(anode_tn);
 
     m_nsigma = get<double>(cfg, "nsigma", m_nsigma);
+    m_fluctuate_threshold = get<double>(cfg, "fluctuate_threshold", m_fluctuate_threshold);
     bool fluctuate = get<bool>(cfg, "fluctuate", false);
     m_rng = nullptr;
     if (fluctuate) {
@@ -93,6 +218,16 @@ void Gen::DepoTransform::configure(const WireCell::Configuration& cfg)
     m_start_time = get<double>(cfg, "start_time", m_start_time);
     m_drift_speed = get<double>(cfg, "drift_speed", m_drift_speed);
     m_frame_count = get<int>(cfg, "first_frame_number", m_frame_count);
+    m_nthreads = std::max(1, get<int>(cfg, "nthreads", m_nthreads));
+    m_patch_lut = get<bool>(cfg, "patch_lut", m_patch_lut);
+    m_patch_lut_precision = get<double>(cfg, "patch_lut_precision", m_patch_lut_precision);
+    m_patch_lut_offsets = get<int>(cfg, "patch_lut_offsets", m_patch_lut_offsets);
+    m_tables.clear();
+    const int cache_mb = get<int>(cfg, "response_cache_mb", (int) (m_cache.capacity() / (1024 * 1024)));
+    if (cache_mb < 0) {
+        THROW(ValueError() << errmsg{String::format("Gen::DepoTransform: negative response_cache_mb: %d", cache_mb)});
+    }
+    m_cache.set_capacity((size_t) cache_mb * 1024 * 1024);
 
     log->debug("tick={} us, start={} us, readin={} us, drift_speed={} mm/us",
                m_tick/units::us, m_start_time/units::us,
@@ -121,6 +256,11 @@ WireCell::Configuration Gen::DepoTransform::default_configuration() const
     /// Whether to fluctuate the final Gaussian deposition.
     put(cfg, "fluctuate", false);
 
+    /// When fluctuating, the mean number of electrons in a patch
+    /// cell above which the normal approximation to the binomial is
+    /// used instead of exact sampling.
+    put(cfg, "fluctuate_threshold", m_fluctuate_threshold);
+
     /// The open a gate.  This is actually a "readin" time measured at
     /// the input ("response") plane.
     put(cfg, "start_time", m_start_time);
@@ -149,72 +289,83 @@ WireCell::Configuration Gen::DepoTransform::default_configuration() const
     // type-name for the DFT to use
     cfg["dft"] = "FftwDFT";
 
+    /// Number of planes to transform concurrently.  Output is the
+    /// same for any value.  When "fluctuate" is true this requires
+    /// an "rng" providing substreams (eg PhiloxRandom), otherwise
+    /// the random numbers are shared by planes in an order that
+    /// depends on thread scheduling when larger than one.
+    put(cfg, "nthreads", m_nthreads);
+
+    /// If true, take the Gaussian bin integrals of each diffusion
+    /// patch from a table keyed by sigma quantized to a relative
+    /// precision and by center offset quantized to 1/offsets of a
+    /// bin.  This trades exactness for fewer erf() calls.
+    put(cfg, "patch_lut", m_patch_lut);
+    put(cfg, "patch_lut_precision", m_patch_lut_precision);
+    put(cfg, "patch_lut_offsets", m_patch_lut_offsets);
+
+    /// Maximum memory in whole MB to hold response spectra which
+    /// repeat for each PIR and transform shape.  Zero disables the
+    /// cache and negative is an error.
+    put(cfg, "response_cache_mb", (int) (m_cache.capacity() / (1024 * 1024)));
+
     return cfg;
 }
 
 bool Gen::DepoTransform::operator()(const input_pointer& in, output_pointer& out)
 {
     if (!in) {
-        log->debug("EOS at call={}", m_count);
+        log->debug("EOS at call={}, response cache hits={} misses={} MB={:.1f}", m_count,
+                   m_cache.hits(), m_cache.misses(), m_cache.nbytes() / (1024.0 * 1024.0));
         ++m_count;
         out = nullptr;
         return true;
     }
 
-    auto depos = in->depos();
+    // Avoid making depo objects of a columnar set just to count them.
+    const auto* cols = in->columns();
+    const size_t ndepos_in = cols ? cols->active.size() : in->depos()->size();
     size_t ndepos_used=0;
 
-    Binning tbins(m_readout_time / m_tick, m_start_time, m_start_time + m_readout_time);
-    ITrace::vector traces;
+    // One job per plane of each face, in a fixed order.
+    std::vector<PlaneJob> jobs;
+    std::vector<IDepo::vector> faces_depos;
+    faces_depos.reserve(m_anode->faces().size());
     for (auto face : m_anode->faces()) {
         // Select the depos which are in this face's sensitive volume
-        IDepo::vector face_depos = Aux::sensitive(*depos, face);
-        ndepos_used += face_depos.size();
+        faces_depos.push_back(Aux::sensitive(in, face));
+        ndepos_used += faces_depos.back().size();
 
         int iplane = -1;
         for (auto plane : face->planes()) {
             ++iplane;
+            jobs.push_back(PlaneJob{face, plane, iplane, &faces_depos.back()});
+        }
+    }
 
-            const Pimpos* pimpos = plane->pimpos();
-
-            Binning tbins(m_readout_time / m_tick, m_start_time, m_start_time + m_readout_time);
-
-            Gen::BinnedDiffusion_transform bindiff(*pimpos, tbins, m_nsigma, m_rng);
-            for (auto depo : face_depos) {
-                depo = modify_depo(plane->planeid(), depo);
-                bindiff.add(depo, depo->extent_long() / m_drift_speed, depo->extent_tran());
-            }
-
-            auto& wires = plane->wires();
-
-            auto pir = m_pirs.at(iplane);
-            Gen::ImpactTransform transform(pir, m_dft, bindiff);
-
-            const int nwires = pimpos->region_binning().nbins();
-            for (int iwire = 0; iwire < nwires; ++iwire) {
-                auto wave = transform.waveform(iwire);
-
-                auto mm = Waveform::edge(wave);
-                if (mm.first == (int) wave.size()) {  // all zero
-                    continue;
-                }
+    if (m_patch_lut) {
+        while (m_tables.size() < jobs.size()) {
+            m_tables.push_back(std::make_unique<GausBinintTable>(m_patch_lut_precision, m_patch_lut_offsets));
+        }
+        for (size_t ind = 0; ind < jobs.size(); ++ind) {
+            jobs[ind].table = m_tables[ind].get();
+        }
+    }
 
-                int chid = wires[iwire]->channel();
-                int tbin = mm.first;
+    run_jobs(jobs);
 
-                ITrace::ChargeSequence charge(wave.begin() + mm.first, wave.begin() + mm.second);
-                auto trace = make_shared<SimpleTrace>(chid, tbin, charge);
-                traces.push_back(trace);
-            }
-            // fixme: use SPDLOG_LOGGER_DEBUG
-            log->debug("plane={} face={} depos={} total traces={}",
-                       iplane, face->ident(), face_depos.size(), traces.size());
-        }
+    // Merge in job order so output does not depend on scheduling.
+    ITrace::vector traces;
+    for (auto& job : jobs) {
+        traces.insert(traces.end(), job.traces.begin(), job.traces.end());
+        // fixme: use SPDLOG_LOGGER_DEBUG
+        log->debug("plane={} face={} depos={} total traces={}",
+                   job.iplane, job.face->ident(), job.depos->size(), traces.size());
     }
 
     auto frame = make_shared<SimpleFrame>(m_frame_count, m_start_time, traces, m_tick);
     log->debug("call={} count={} ndepos_in={} ndepos_used={}",
-               m_count, m_frame_count, depos->size(), ndepos_used);
+               m_count, m_frame_count, ndepos_in, ndepos_used);
     log->debug("output: {}", Aux::taginfo(frame));
 
     ++m_frame_count;
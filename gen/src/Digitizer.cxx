@@ -8,7 +8,11 @@
 
 #include "WireCellUtil/Testing.h"
 #include "WireCellUtil/NamedFactory.h"
+
+#include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <unordered_map>
 
 WIRECELL_FACTORY(Digitizer, WireCell::Gen::Digitizer,
                  WireCell::INamed,
@@ -92,6 +96,31 @@ double Gen::Digitizer::digitize(double voltage)
     return floor(fp_adc);
 }
 
+namespace {
+    // Branch free form of Digitizer::digitize(double) with constants
+    // hoisted so that loops over it may vectorize.
+    struct DigitizeKernel {
+        double gain, vmin, vrange, adcmax, offset;
+
+        float operator()(float sample, float baseline) const
+        {
+            const double voltage = gain * sample + baseline;
+            const double fp_adc = (voltage - vmin) / vrange * adcmax;
+            // Clamped to be non-negative so truncation is floor().
+            return int(std::min(std::max(fp_adc, 0.0), adcmax) + offset);
+        }
+    };
+}  // namespace
+
+void Gen::Digitizer::digitize(float* wave, size_t n, float baseline) const
+{
+    const DigitizeKernel kern{m_gain, m_fullscale[0], m_fullscale[1] - m_fullscale[0],
+                              double((1 << m_resolution) - 1), m_round ? 0.5 : 0.0};
+    for (size_t ind = 0; ind < n; ++ind) {
+        wave[ind] = kern(wave[ind], baseline);
+    }
+}
+
 bool Gen::Digitizer::operator()(const input_pointer& vframe, output_pointer& adcframe)
 {
     if (!vframe) {  // EOS
@@ -111,42 +140,50 @@ bool Gen::Digitizer::operator()(const input_pointer& vframe, output_pointer& adc
     }
 
     // Get extent in channel and tbin
-    auto channels = Aux::channels(vtraces);
-    std::sort(channels.begin(), channels.end());
-    auto chbeg = channels.begin();
-    auto chend = std::unique(chbeg, channels.end());
+    auto channels = Aux::channels(vtraces, true);
     auto tbinmm = Aux::tbin_range(vtraces);
-
-    const size_t ncols = tbinmm.second - tbinmm.first;
-    const size_t nrows = std::distance(chbeg, chend);
-
-    // make a dense array working space.  a row is one trace.  a
-    // column is one tick.
-    Array::array_xxf arr = Array::array_xxf::Zero(nrows, ncols);
-    Aux::fill(arr, vtraces, channels.begin(), chend, tbinmm.first);
-
-    ITrace::vector adctraces(nrows);
-
-    double totadc = 0;
-
-    for (size_t irow = 0; irow < nrows; ++irow) {
-        int ch = channels[irow];
+    const int tbin0 = tbinmm.first;
+    const size_t ncols = tbinmm.second - tbin0;
+
+    // Each output trace is used directly as the working row.  The
+    // plane baseline is resolved once per row.
+    std::vector<std::shared_ptr<SimpleTrace>> rows;
+    std::vector<float> baselines;
+    std::unordered_map<int, size_t> row_index;
+    for (int ch : channels) {
         WirePlaneId wpid = m_anode->resolve(ch);
         if (!wpid.valid()) {
             log->warn("got invalid WPID for channel {}: {}, skipping", ch, wpid);
             continue;
         }
-        const float baseline = m_baselines[wpid.index()];
-
-        ITrace::ChargeSequence adcwave(ncols);
-        for (size_t icol = 0; icol < ncols; ++icol) {
-            double voltage = m_gain * arr(irow, icol) + baseline;
-            const float adcf = digitize(voltage);
-            adcwave[icol] = adcf;
-            totadc += adcf;
+        row_index[ch] = rows.size();
+        rows.push_back(make_shared<SimpleTrace>(ch, tbin0, ncols));
+        baselines.push_back(m_baselines[wpid.index()]);
+    }
+
+    for (const auto& vtrace : vtraces) {
+        auto it = row_index.find(vtrace->channel());
+        if (it == row_index.end()) {
+            continue;
+        }
+        const auto& charge = vtrace->charge();
+        float* row = rows[it->second]->charge().data() + (vtrace->tbin() - tbin0);
+        for (size_t ind = 0; ind < charge.size(); ++ind) {
+            row[ind] += charge[ind];
         }
-        adctraces[irow] = make_shared<SimpleTrace>(ch, tbinmm.first, adcwave);
     }
+
+    ITrace::vector adctraces(rows.size());
+    double totadc = 0;
+    for (size_t irow = 0; irow < rows.size(); ++irow) {
+        auto& adcwave = rows[irow]->charge();
+        digitize(adcwave.data(), ncols, baselines[irow]);
+        for (auto adc : adcwave) {
+            totadc += adc;
+        }
+        adctraces[irow] = rows[irow];
+    }
+
     auto sframe = make_shared<SimpleFrame>(vframe->ident(), vframe->time(), adctraces, vframe->tick(), vframe->masks());
     if (!m_frame_tag.empty()) {
         sframe->tag_frame(m_frame_tag);
@@ -2,6 +2,7 @@
 #include "WireCellUtil/NamedFactory.h"
 #include "WireCellUtil/Units.h"
 #include "WireCellUtil/String.h"
+#include "WireCellUtil/Parallel.h"
 
 #include "WireCellIface/IAnodePlane.h"
 #include "WireCellIface/IAnodeFace.h"
@@ -10,6 +11,8 @@
 
 #include <boost/range.hpp>
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 WIRECELL_FACTORY(Drifter, WireCell::Gen::Drifter,
@@ -86,6 +89,11 @@ WireCell::Configuration Gen::Drifter::default_configuration() const
     cfg["drift_speed"] = m_speed;
     cfg["time_offset"] = m_toffset;
 
+    // In batch mode each xregion draws fluctuations from a substream
+    // of "rng" keyed by this id, the depo set ident and the xregion
+    // index.  Give each drifter sharing one "rng" a distinct id.
+    cfg["stream_id"] = (int) m_stream_id;
+
     // see comments in .h file
     cfg["xregions"] = Json::arrayValue;
     return cfg;
@@ -104,6 +112,7 @@ void Gen::Drifter::configure(const WireCell::Configuration& cfg)
     m_fluctuate = get<bool>(cfg, "fluctuate", m_fluctuate);
     m_speed = get<double>(cfg, "drift_speed", m_speed);
     m_toffset = get<double>(cfg, "time_offset", m_toffset);
+    m_stream_id = get<int>(cfg, "stream_id", m_stream_id);
 
     auto jxregions = cfg["xregions"];
     if (jxregions.empty()) {
@@ -125,10 +134,29 @@ void Gen::Drifter::configure(const WireCell::Configuration& cfg)
 void Gen::Drifter::reset() { m_xregions.clear(); }
 
 bool Gen::Drifter::insert(const input_pointer& depo)
+{
+    size_t region = 0;
+    auto newdepo = drift_one(depo, region);
+    if (!newdepo) {
+        return false;
+    }
+    m_xregions[region].depos.insert(newdepo);
+    return true;
+}
+
+IDepo::pointer Gen::Drifter::drift_one(const input_pointer& depo, size_t& region)
+{
+    double direction = 0.0;
+    if (!find_region(depo, region, direction)) {
+        return nullptr;
+    }
+    return drift_in(depo, m_xregions[region], direction, *m_rng);
+}
+
+bool Gen::Drifter::find_region(const input_pointer& depo, size_t& region, double& direction) const
 {
     // electrical charge to drift.  Electrons should be negative
-    const double Qi = depo->charge();
-    if (Qi == 0.0) {
+    if (depo->charge() == 0.0) {
         // Yes, some silly depo sources ask us to drift nothing....
         return false;
     }
@@ -139,26 +167,30 @@ bool Gen::Drifter::insert(const input_pointer& depo)
     // and then at worse only explicitly check extent partial bins
     // near to their edges.
 
-    double respx = 0, direction = 0.0;
-
     auto xrit = std::find_if(m_xregions.begin(), m_xregions.end(), Gen::Drifter::IsInsideResp(depo));
     if (xrit != m_xregions.end()) {
         // Back up in space and time.  This is a best effort fudge.  See:
         // https://github.com/WireCell/wire-cell-gen/issues/22
-
-        respx = xrit->response;
         direction = -1.0;
     }
     else {
         xrit = std::find_if(m_xregions.begin(), m_xregions.end(), Gen::Drifter::IsInsideBulk(depo));
         if (xrit != m_xregions.end()) {  // in bulk
-            respx = xrit->response;
             direction = 1.0;
         }
     }
     if (xrit == m_xregions.end()) {
         return false;  // outside both regions
     }
+    region = std::distance(m_xregions.begin(), xrit);
+    return true;
+}
+
+IDepo::pointer Gen::Drifter::drift_in(const input_pointer& depo, const Xregion& xr, double direction,
+                                      IRandom& rng) const
+{
+    const double Qi = depo->charge();
+    const double respx = xr.response;
 
     Point pos = depo->pos();
     const double dt = std::abs((respx - pos.x()) / m_speed);
@@ -181,7 +213,7 @@ bool Gen::Drifter::insert(const input_pointer& depo)
             if (Qi < 0) {
                 sign = -1.0;
             }
-            dQ = sign * m_rng->binomial((int) std::abs(Qi), absorbprob);
+            dQ = sign * rng.binomial((int) std::abs(Qi), absorbprob);
         }
         Qf = Qi - dQ;
 
@@ -189,54 +221,163 @@ bool Gen::Drifter::insert(const input_pointer& depo)
         dT = sqrt(2.0 * m_DT * dt + dT * dT);
     }
 
-    auto newdepo = make_shared<Aux::SimpleDepo>(depo->time() + direction * dt + m_toffset,
-                                                pos, Qf, depo, dL, dT, depo->id());
-    xrit->depos.insert(newdepo);
-    return true;
+    return make_shared<Aux::SimpleDepo>(depo->time() + direction * dt + m_toffset,
+                                        pos, Qf, depo, dL, dT, depo->id());
+}
+
+// K-way merge of time ordered ranges onto the output.  Ties go to the
+// lower range so the order is deterministic.
+template <typename Iter, typename Out>
+static void merge_by_time(const std::vector<std::pair<Iter, Iter>>& ranges, Out& out)
+{
+    struct Head {
+        Iter beg, end;
+        size_t index;
+    };
+    std::vector<Head> heads;
+    for (size_t ind = 0; ind < ranges.size(); ++ind) {
+        if (ranges[ind].first != ranges[ind].second) {
+            heads.push_back(Head{ranges[ind].first, ranges[ind].second, ind});
+        }
+    }
+    if (heads.size() <= 1) {
+        for (const auto& head : heads) {
+            out.insert(out.end(), head.beg, head.end);
+        }
+        return;
+    }
+    auto later = [](const Head& a, const Head& b) {
+        const double ta = (*a.beg)->time(), tb = (*b.beg)->time();
+        if (ta == tb) {
+            return a.index > b.index;
+        }
+        return ta > tb;
+    };
+    std::make_heap(heads.begin(), heads.end(), later);
+    while (!heads.empty()) {
+        std::pop_heap(heads.begin(), heads.end(), later);
+        auto& head = heads.back();
+        out.push_back(*head.beg);
+        if (++head.beg == head.end) {
+            heads.pop_back();
+            continue;
+        }
+        std::push_heap(heads.begin(), heads.end(), later);
+    }
 }
 
-bool by_time(const IDepo::pointer& lhs, const IDepo::pointer& rhs) { return lhs->time() < rhs->time(); }
+// Move ripe depos from all region buffers to the output in time order.
+void Gen::Drifter::take_ripe(output_queue& outq, double now)
+{
+    // Each region buffer is time ordered so its ripe depos are a
+    // prefix of it.  Most calls find none.
+    auto is_ripe = [now](const Xregion& xr) {
+        return !xr.depos.empty() and (*xr.depos.begin())->time() < now;
+    };
+    if (std::none_of(m_xregions.begin(), m_xregions.end(), is_ripe)) {
+        return;
+    }
+    using depo_iter = Xregion::ordered_depos_t::iterator;
+    std::vector<std::pair<depo_iter, depo_iter>> ripes;
+    ripes.reserve(m_xregions.size());
+    for (auto& xr : m_xregions) {
+        auto end = xr.depos.begin();
+        while (end != xr.depos.end() and (*end)->time() < now) {
+            ++end;
+        }
+        ripes.emplace_back(xr.depos.begin(), end);
+    }
+    merge_by_time(ripes, outq);
+    for (size_t ind = 0; ind < m_xregions.size(); ++ind) {
+        m_xregions[ind].depos.erase(ripes[ind].first, ripes[ind].second);
+    }
+}
 
 // save all cached depos to the output queue sorted in time order
 void Gen::Drifter::flush(output_queue& outq)
 {
-    for (auto& xr : m_xregions) {
-        outq.insert(outq.end(), xr.depos.begin(), xr.depos.end());
-        xr.depos.clear();
-    }
-    std::sort(outq.begin(), outq.end(), by_time);
+    take_ripe(outq, std::numeric_limits<double>::infinity());
     outq.push_back(nullptr);
 }
 
 void Gen::Drifter::flush_ripe(output_queue& outq, double now)
 {
-    // It might be faster to use a sorted set which would avoid an
-    // exhaustive iteration of each depos stash.  Or not.
-    for (auto& xr : m_xregions) {
-        if (xr.depos.empty()) {
+    take_ripe(outq, now);
+}
+
+IDepo::vector Gen::Drifter::drift(const IDepo::vector& depos, int ident, size_t nthreads)
+{
+    IDepo::vector out;
+    if (m_speed <= 0.0) {
+        log->error("illegal drift speed: {}", m_speed);
+        return out;
+    }
+    const size_t nregions = m_xregions.size();
+
+    // Partition by region, keeping input order within each.
+    std::vector<IDepo::vector> inputs(nregions);
+    std::vector<std::vector<double>> directions(nregions);
+    for (const auto& depo : depos) {
+        size_t region = 0;
+        double direction = 0;
+        if (!find_region(depo, region, direction)) {
+            ++n_dropped;
             continue;
         }
+        ++n_drifted;
+        inputs[region].push_back(depo);
+        directions[region].push_back(direction);
+    }
 
-        Xregion::ordered_depos_t::const_iterator depo_beg = xr.depos.begin(), depo_end = xr.depos.end();
-        Xregion::ordered_depos_t::iterator depoit = depo_beg;
-        while (depoit != depo_end) {
-            if ((*depoit)->time() < now) {
-                ++depoit;
-                continue;
+    // Each region draws from its own substream so results depend on
+    // the data and this drifter and not on the number of threads.
+    // Without substreams a shared generator forces the regions to run
+    // serially and in order.
+    std::vector<IRandom::pointer> rngs(nregions, m_rng);
+    if (m_fluctuate) {
+        for (size_t region = 0; region < nregions; ++region) {
+            auto sub = m_rng->substream({(uint64_t) m_stream_id, (uint64_t) ident, (uint64_t) region});
+            if (!sub) {
+                rngs.assign(nregions, m_rng);
+                nthreads = 1;
+                break;
             }
-            break;
-        }
-        if (depoit == depo_beg) {
-            continue;
+            rngs[region] = sub;
         }
+    }
 
-        outq.insert(outq.end(), depo_beg, depoit);
-        xr.depos.erase(depo_beg, depoit);
+    // Drift and sort each region.
+    std::vector<IDepo::vector> drifted(nregions);
+    auto do_region = [&](size_t region) {
+        const auto& in = inputs[region];
+        auto& one = drifted[region];
+        one.reserve(in.size());
+        for (size_t ind = 0; ind < in.size(); ++ind) {
+            one.push_back(drift_in(in[ind], m_xregions[region], directions[region][ind], *rngs[region]));
+        }
+        std::stable_sort(one.begin(), one.end(), [](const IDepo::pointer& a, const IDepo::pointer& b) {
+            return a->time() < b->time();
+        });
+    };
+    parallel_for(nregions, do_region, nthreads);
+
+    using depo_iter = IDepo::vector::const_iterator;
+    std::vector<std::pair<depo_iter, depo_iter>> ranges;
+    for (const auto& one : drifted) {
+        ranges.emplace_back(one.cbegin(), one.cend());
+        out.reserve(out.size() + one.size());
     }
-    if (outq.empty()) {
-        return;
+    merge_by_time(ranges, out);
+
+    if (n_dropped) {
+        log->debug("batch of {}, "
+                   "( dropped:{} + drifted:{} ) / total:{} depos "
+                   "from set, outside of all {} drift xregions",
+                   depos.size(), n_dropped, n_drifted, n_dropped + n_drifted,
+                   m_xregions.size());
     }
-    std::sort(outq.begin(), outq.end(), by_time);
+    n_drifted = n_dropped = 0;
+    return out;
 }
 
 // always returns true because by hook or crook we consume the input.
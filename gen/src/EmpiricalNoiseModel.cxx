@@ -13,6 +13,7 @@
 #include "WireCellAux/DftTools.h"
 
 #include <iostream>  // debug
+#include <string_view>
 
 WIRECELL_FACTORY(EmpiricalNoiseModel,
                  WireCell::Gen::EmpiricalNoiseModel,
@@ -325,43 +326,53 @@ Gen::EmpiricalNoiseModel::get_spectrum_data(int iplane, int ilen) const
 const IChannelSpectrum::amplitude_t&
 Gen::EmpiricalNoiseModel::channel_spectrum(int chid) const
 {
-    auto packkeyit = m_channel_packkey_cache.find(chid);
-    if (packkeyit != m_channel_packkey_cache.end()) {
-        unsigned int packkey = packkeyit->second;
-        auto cacit = m_channel_amp_cache.find(packkey);
-        if (cacit != m_channel_amp_cache.end()) {
-            return cacit->second;
-        }
-    }
+    std::lock_guard<std::mutex> lock(m_mutex_cache);
+    return bank_spectrum(chid);
+}
 
+size_t Gen::EmpiricalNoiseModel::nspectra() const
+{
     std::lock_guard<std::mutex> lock(m_mutex_cache);
-    // get truncated wire length for cache
-    int ilen = 0;
-    auto chlen = m_chid_to_intlen.find(chid);
-    if (chlen == m_chid_to_intlen.end()) {  // new channel
-        auto wires = m_anode->wires(chid);  // sum up wire length
-        double len = 0.0;
-        for (auto wire : wires) {
-            len += ray_length(wire->ray());
+    return m_spectrum_bank.size();
+}
+
+size_t Gen::EmpiricalNoiseModel::bank_index(amplitude_t&& amp) const
+{
+    const std::string_view bytes((const char*) amp.data(), amp.size() * sizeof(float));
+    const size_t hash = std::hash<std::string_view>{}(bytes);
+    auto range = m_bank_hash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (m_spectrum_bank[it->second] == amp) {
+            return it->second;
         }
-        // cache every cm ...
-        ilen = int(len / m_wlres);
-        // there might be  aproblem with the wire length's unit
-        // ilen = int(len);
-        m_chid_to_intlen[chid] = ilen; // fixme: not thread safe
     }
-    else {
-        ilen = chlen->second;
+    const size_t index = m_spectrum_bank.size();
+    m_spectrum_bank.push_back(std::move(amp));
+    m_bank_hash.emplace(hash, index);
+    return index;
+}
+
+// Caller must hold the cache mutex.
+const IChannelSpectrum::amplitude_t&
+Gen::EmpiricalNoiseModel::bank_spectrum(int chid) const
+{
+    auto chit = m_chid_index.find(chid);
+    if (chit != m_chid_index.end()) {
+        return m_spectrum_bank[chit->second];
+    }
+
+    // get truncated wire length for cache
+    auto wires = m_anode->wires(chid);  // sum up wire length
+    double len = 0.0;
+    for (auto wire : wires) {
+        len += ray_length(wire->ray());
     }
+    // cache every cm ...
+    const int ilen = int(len / m_wlres);
 
-    // saved content
     auto wpid = m_anode->resolve(chid);
     const int iplane = wpid.index();
 
-    // Must copy as next apply channel-specific changes.
-    auto [constant, amp] = get_spectrum_data(iplane, ilen);
-    const size_t namps = amp.size();
-
     // Convert from as-built to as-designed.
     const double db_gain = gain(chid);
     const double db_shaping = shaping_time(chid);
@@ -371,6 +382,32 @@ Gen::EmpiricalNoiseModel::channel_spectrum(int chid) const
         ch_shaping = m_chanstat->preamp_shaping(chid);
     }
 
+    struct PWGS {
+        unsigned int p;
+        unsigned int w;
+        unsigned int g;
+        unsigned int s;
+        unsigned int operator() () {
+            return (
+                ((p & 0b111) << 29) // 0 - 65535 length steps
+                | ((w & 0b111111111111) << 16) // 0 - 65535 length steps
+                | ((g & 0xFF) << 8) // 0 - 255 gain steps
+                | (s & 0xFF)
+                ); // 0 - 255 shaping steps
+        } 
+    } pack{(unsigned int)iplane, (unsigned int)ilen, (unsigned int)(ch_gain/m_gres), (unsigned int)(ch_shaping/m_sres)};
+
+    const unsigned int packkey = pack();
+    auto pkit = m_packkey_index.find(packkey);
+    if (pkit != m_packkey_index.end()) {
+        m_chid_index[chid] = pkit->second;
+        return m_spectrum_bank[pkit->second];
+    }
+
+    // Must copy as next apply channel-specific changes.
+    auto [constant, amp] = get_spectrum_data(iplane, ilen);
+    const size_t namps = amp.size();
+
     // Convert gain.
     if (fabs(ch_gain - db_gain) > 0.01 * ch_gain) {
         Waveform::scale(amp, ch_gain / db_gain);
@@ -416,24 +453,8 @@ Gen::EmpiricalNoiseModel::channel_spectrum(int chid) const
         val = sqrt(val*val + constant_squared); // units still in mV
     }
 
-    struct PWGS {
-        unsigned int p;
-        unsigned int w;
-        unsigned int g;
-        unsigned int s;
-        unsigned int operator() () {
-            return (
-                ((p & 0b111) << 29) // 0 - 65535 length steps
-                | ((w & 0b111111111111) << 16) // 0 - 65535 length steps
-                | ((g & 0xFF) << 8) // 0 - 255 gain steps
-                | (s & 0xFF)
-                ); // 0 - 255 shaping steps
-        } 
-    } pack{(unsigned int)iplane, (unsigned int)ilen, (unsigned int)(ch_gain/m_gres), (unsigned int)(ch_shaping/m_sres)};
-
-    unsigned int packkey = pack();
-    m_channel_packkey_cache[chid] = packkey;
-    // m_channel_amp_cache.clear();
-    m_channel_amp_cache[packkey] = amp;
-    return channel_spectrum(chid);
+    const size_t index = bank_index(std::move(amp));
+    m_packkey_index[packkey] = index;
+    m_chid_index[chid] = index;
+    return m_spectrum_bank[index];
 }
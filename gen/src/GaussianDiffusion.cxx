@@ -1,5 +1,6 @@
 #include "WireCellGen/GaussianDiffusion.h"
 
+#include <cmath>
 #include <iostream>  // debugging
 
 using namespace WireCell;
@@ -101,6 +102,46 @@ std::vector<double> Gen::GausDesc::weight(double start, double step, int nbins,
 //     return std::make_pair(std::max(imin, 0), std::min(imax+1, nsamples));
 // }
 
+/// GausBinintTable
+
+Gen::GausBinintTable::GausBinintTable(double sigma_precision, int noffsets, size_t max_entries)
+  : m_log_precision(std::log1p(sigma_precision))
+  , m_noffsets(noffsets)
+  , m_max_entries(max_entries)
+{
+}
+
+std::vector<double> Gen::GausBinintTable::binint(const GausDesc& gd, double start, double step, int nbins)
+{
+    if (!gd.sigma or nbins <= 0) {
+        return gd.binint(start, step, nbins);
+    }
+
+    // In units of the bin size.
+    const double rel_sigma = gd.sigma / step;
+    const double rel_offset = (gd.center - start) / step;
+    const int64_t qsigma = std::lround(std::log(rel_sigma) / m_log_precision);
+    const int64_t qoffset = std::lround(rel_offset * m_noffsets);
+
+    // 24 bits for each of sigma and offset and 16 for the bins.
+    const uint64_t key = ((uint64_t)(qsigma & 0xffffff) << 40) | ((uint64_t)(qoffset & 0xffffff) << 16) |
+                         ((uint64_t) nbins & 0xffff);
+    auto it = m_table.find(key);
+    if (it != m_table.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_misses;
+
+    // The quantized Gaussian on unit bins starting at zero.
+    const GausDesc qgd(double(qoffset) / m_noffsets, std::exp(qsigma * m_log_precision));
+    auto bins = qgd.binint(0.0, 1.0, nbins);
+    if (m_table.size() < m_max_entries) {
+        m_table.emplace(key, bins);
+    }
+    return bins;
+}
+
 /// GaussianDiffusion
 
 Gen::GaussianDiffusion::GaussianDiffusion(const IDepo::pointer& depo, const GausDesc& time_desc,
@@ -115,7 +156,8 @@ Gen::GaussianDiffusion::GaussianDiffusion(const IDepo::pointer& depo, const Gaus
 
 void Gen::GaussianDiffusion::set_sampling(const Binning& tbin,  // overall time tick binning
                                           const Binning& pbin,  // overall impact position binning
-                                          double nsigma, IRandom::pointer fluctuate, unsigned int weightstrat)
+                                          double nsigma, IRandom::pointer fluctuate, unsigned int weightstrat,
+                                          GausBinintTable* table, double fluctuate_threshold)
 {
     if (m_patch.size() > 0) {
         return;
@@ -127,7 +169,8 @@ void Gen::GaussianDiffusion::set_sampling(const Binning& tbin,  // overall time
     const size_t ntss = tbin_range.second - tbin_range.first;
     m_toffset_bin = tbin_range.first;
     // auto tvec =  m_time_desc.sample(tbin.center(m_toffset_bin), tbin.binsize(), ntss);
-    auto tvec = m_time_desc.binint(tbin.edge(m_toffset_bin), tbin.binsize(), ntss);
+    auto tvec = table ? table->binint(m_time_desc, tbin.edge(m_toffset_bin), tbin.binsize(), ntss)
+                      : m_time_desc.binint(tbin.edge(m_toffset_bin), tbin.binsize(), ntss);
 
     if (!ntss) {
         cerr << "Gen::GaussianDiffusion: no time bins for [" << tval_range.first / units::us << ","
@@ -141,7 +184,8 @@ void Gen::GaussianDiffusion::set_sampling(const Binning& tbin,  // overall time
     const size_t npss = pbin_range.second - pbin_range.first;
     m_poffset_bin = pbin_range.first;
     // auto pvec = m_pitch_desc.sample(pbin.center(m_poffset_bin), pbin.binsize(), npss);
-    auto pvec = m_pitch_desc.binint(pbin.edge(m_poffset_bin), pbin.binsize(), npss);
+    auto pvec = table ? table->binint(m_pitch_desc, pbin.edge(m_poffset_bin), pbin.binsize(), npss)
+                      : m_pitch_desc.binint(pbin.edge(m_poffset_bin), pbin.binsize(), npss);
 
     if (!npss) {
         cerr << "No impact bins [" << pval_range.first / units::mm << "," << pval_range.second / units::mm << "] mm\n";
@@ -161,56 +205,30 @@ void Gen::GaussianDiffusion::set_sampling(const Binning& tbin,  // overall time
     }
 
     // start making the time vs impact patch of charge.
-    patch_t ret = patch_t::Zero(npss, ntss);
-    double raw_sum = 0.0;
-
-    // Convolve the two independent Gaussians
-    for (size_t ip = 0; ip < npss; ++ip) {
-        for (size_t it = 0; it < ntss; ++it) {
-            const double val = pvec[ip] * tvec[it];
-            raw_sum += val;
-            ret(ip, it) = (float) val;
-        }
-    }
-
-    // Depo charge should be in units of "e" so negative, but
-    // explicitly track sign in case positive charge is given.
+    // Convolve the two independent Gaussians as an outer product.
+    Eigen::Map<const Eigen::ArrayXd> parr(pvec.data(), npss);
+    Eigen::Map<const Eigen::ArrayXd> tarr(tvec.data(), ntss);
+    patch_t ret = (parr.matrix() * tarr.matrix().transpose()).array().cast<float>();
+    const double raw_sum = parr.sum() * tarr.sum();
+
+    // Depo charge should be in units of "e" so negative but the
+    // sign is carried through in case positive charge is given.
     const double depo_charge = m_deposition->charge();
-    const double charge_sign = depo_charge < 0 ? -1 : 1;
 
     // normalize to total charge
     ret *= depo_charge / raw_sum;
 
-    double fluc_sum = 0;
     if (fluctuate) {
-
-        for (size_t ip = 0; ip < npss; ++ip) {
-            for (size_t it = 0; it < ntss; ++it) {
-                const double oldval = ret(ip, it);
-                // should be a multinomial distribution, n_i follows binomial distribution
-                // but n_i, n_j has covariance -n_tot * p_i * p_j
-                // normalize later to approximate this multinomial distribution (how precise?)
-                // how precise? better than poisson and 10000 total charge corresponds to a <1% level error.
-                double number = 0.0;
-                const double relval = oldval / depo_charge;
-                if (relval >= 1.0) {
-                    number = (int) std::abs(depo_charge);
-                }
-                else {
-                    number = fluctuate->binomial((int) std::abs(depo_charge), relval);
-                }
-                // the charge should be negative -- ionization electrons
-                number *= charge_sign;
-                fluc_sum += number;
-                ret(ip, it) = number;
-            }
-        }
-        if (fluc_sum == 0) {
+        // Sample the number of electrons in each cell from the
+        // multinomial distribution so that their total is preserved.
+        const int ntotal = (int) std::abs(depo_charge);
+        if (!ntotal) {
             return;
         }
-        else {
-            ret *= m_deposition->charge() / fluc_sum;
-        }
+        ret *= 1.0 / depo_charge;
+        Multinomial multinomial(fluctuate, fluctuate_threshold);
+        multinomial(ntotal, ret.data(), ret.size());
+        ret *= depo_charge / ntotal;
     }
 
     {  // debugging
@@ -18,7 +18,8 @@ using WireCell::Aux::DftTools::inv_c2r;
 
 Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
                                       const IDFT::pointer& dft,
-                                      BinnedDiffusion_transform& bd)
+                                      BinnedDiffusion_transform& bd,
+                                      ImpactTransformCache* cache)
   : m_pir(pir)
   , m_dft(dft)
   , m_bd(bd)
@@ -68,16 +69,8 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
         }
 
         m_vec_map_resp.push_back(map_resp);
-
-        std::vector<std::tuple<int, int, double> > vec_charge;  // ch, time, charge
-        m_vec_vec_charge.push_back(vec_charge);
     }
 
-    // now work on the charge part ...
-    // trying to sampling ...
-    m_bd.get_charge_vec(m_vec_vec_charge, m_vec_impact);
-    // std::cout << nwires << " " << nsamples << std::endl;
-
     // length and width ...
 
     //    std::cout << nwires << " " << nsamples << std::endl;
@@ -114,95 +107,49 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
     m_start_tick = start_tick;
     m_end_tick = end_tick + npad_time;
 
-    Array::array_xxc acc_data_f_w =
-        Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
+    const int nwires = end_ch - start_ch + 2 * npad_wire;
+    const int nticks = m_end_tick - m_start_tick;
+
+    // now work on the charge part ...
+    // sample into one (wire, tick) grid per impact group
+    std::vector<ChargeBlocks> vec_charge(m_num_group, ChargeBlocks(nwires, nticks));
+    m_bd.get_charge_matrix(vec_charge, m_vec_impact, start_ch - npad_wire, m_start_tick);
+
+    Array::array_xxc acc_data_f_w = Array::array_xxc::Zero(nwires, nticks);
 
-    int num_double = (m_vec_vec_charge.size() - 1) / 2;
+    int num_double = (vec_charge.size() - 1) / 2;
+
+    // The response spectra depend only on the PIR and the shape.
+    auto make_spectra = [&]() { return response_spectra(num_double + 1, nwires, nticks); };
+    ImpactTransformCache::spectra_ptr spectra;
+    if (cache) {
+        spectra = cache->get(m_pir, nwires, nticks, make_spectra);
+    }
+    else {
+        spectra = std::make_shared<const ImpactTransformCache::spectra_t>(make_spectra());
+    }
 
     // speed up version , first five
     for (int i = 0; i != num_double; i++) {
         // if (i!=0) continue;
         // std::cout << i << std::endl;
-        Array::array_xxc c_data = Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
+        Array::array_xxc c_data(nwires, nticks);
 
         // fill normal order
-        for (size_t j = 0; j != m_vec_vec_charge.at(i).size(); j++) {
-            c_data(std::get<0>(m_vec_vec_charge.at(i).at(j)) + npad_wire - start_ch,
-                   std::get<1>(m_vec_vec_charge.at(i).at(j)) - m_start_tick) +=
-                std::get<2>(m_vec_vec_charge.at(i).at(j));
-        }
-        //    std::cout << i << " " << m_vec_vec_charge.at(i).size() << std::endl;
-        m_vec_vec_charge.at(i).clear();
-        m_vec_vec_charge.at(i).shrink_to_fit();
+        c_data.real() = vec_charge.at(i).dense();
+        vec_charge.at(i).clear();
 
         // fill reverse order
         int ii = num_double * 2 - i;
-        for (size_t j = 0; j != m_vec_vec_charge.at(ii).size(); j++) {
-            c_data(end_ch + npad_wire - 1 - std::get<0>(m_vec_vec_charge.at(ii).at(j)),
-                   std::get<1>(m_vec_vec_charge.at(ii).at(j)) - m_start_tick) +=
-                std::complex<float>(0, std::get<2>(m_vec_vec_charge.at(ii).at(j)));
-        }
-        //    std::cout << ii << " " << m_vec_vec_charge.at(ii).size() << std::endl;
-        m_vec_vec_charge.at(ii).clear();
-        m_vec_vec_charge.at(ii).shrink_to_fit();
+        c_data.imag() = vec_charge.at(ii).dense().colwise().reverse();
+        vec_charge.at(ii).clear();
 
         // Do FFT on time
         // Do FFT on wire
         c_data = fwd(m_dft, c_data);
 
-        // std::cout << i << std::endl;
-        {
-            Array::array_xxc resp_f_w =
-                Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
-            {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[0]->spectrum();
-                // do a inverse FFT
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                // pick the first xxx ticks
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                }
-                // do a FFT
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    resp_f_w(0, icol) = rs1[icol];
-                }
-            }
-
-            for (int irow = 0; irow != m_num_pad_wire; irow++) {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[irow + 1]->spectrum();
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                }
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-                Waveform::compseq_t rs2 = m_vec_map_resp.at(i)[-irow - 1]->spectrum();
-                Waveform::realseq_t rs2_t = inv_c2r(m_dft, rs2);
-                Waveform::realseq_t rs2_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs2_t.size())) break;
-                    rs2_reduced.at(icol) = rs2_t[icol];
-                }
-                rs2 = fwd_r2c(m_dft, rs2_reduced);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    resp_f_w(irow + 1, icol) = rs1[icol];
-                    resp_f_w(end_ch - start_ch - 1 - irow + 2 * npad_wire, icol) = rs2[icol];
-                }
-            }
-            // std::cout << i << std::endl;
-
-            // Do FFT on wire for response // slight larger
-            // Now becomes the f and f in both time and wire domain ...
-            resp_f_w = fwd(m_dft, resp_f_w, 0);
-
-            // multiply them together
-            c_data = c_data * resp_f_w;
-        }
+        // multiply with the response
+        c_data = c_data * spectra->at(i);
 
         // Do inverse FFT on wire
         c_data = inv(m_dft, c_data, 0);
@@ -220,18 +167,9 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
 
         Array::array_xxc data_f_w;
         {
-            Array::array_xxf data_t_w =
-                Array::array_xxf::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
-            // fill charge array in time-wire domain // slightly larger
-            for (size_t j = 0; j != m_vec_vec_charge.at(i).size(); j++) {
-                data_t_w(std::get<0>(m_vec_vec_charge.at(i).at(j)) + npad_wire - start_ch,
-                         std::get<1>(m_vec_vec_charge.at(i).at(j)) - m_start_tick) +=
-                    std::get<2>(m_vec_vec_charge.at(i).at(j));
-                // std::cout << std::get<1>(m_vec_vec_charge.at(i).at(j)) << std::endl;
-            }
-            //      std::cout << i << " " << m_vec_vec_charge.at(i).size() << std::endl;
-            m_vec_vec_charge.at(i).clear();
-            m_vec_vec_charge.at(i).shrink_to_fit();
+            // charge array in time-wire domain // slightly larger
+            Array::array_xxf data_t_w = vec_charge.at(i).dense();
+            vec_charge.at(i).clear();
 
             // Do FFT on time
             data_f_w = fwd_r2c(m_dft, data_t_w, 1);
@@ -239,59 +177,8 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
             data_f_w = fwd(m_dft, data_f_w, 0);
         }
 
-        {
-            Array::array_xxc resp_f_w =
-                Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
-
-            {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[0]->spectrum();
-
-                // do a inverse FFT
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                // pick the first xxx ticks
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                // std::cout << rs1.size() << " " << nsamples << " " << m_end_tick << " " <<  m_start_tick << std::endl;
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                    //  std::cout << icol << " " << rs1_t[icol] << std::endl;
-                }
-                // do a FFT
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    //   std::cout << icol << " " << rs1[icol] << " " << temp_resp_f_w(0,icol) << std::endl;
-                    resp_f_w(0, icol) = rs1[icol];
-                }
-            }
-            for (int irow = 0; irow != m_num_pad_wire; irow++) {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[irow + 1]->spectrum();
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                }
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-                Waveform::compseq_t rs2 = m_vec_map_resp.at(i)[-irow - 1]->spectrum();
-                Waveform::realseq_t rs2_t = inv_c2r(m_dft, rs2);
-                Waveform::realseq_t rs2_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs2_t.size())) break;
-                    rs2_reduced.at(icol) = rs2_t[icol];
-                }
-                rs2 = fwd_r2c(m_dft, rs2_reduced);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    resp_f_w(irow + 1, icol) = rs1[icol];
-                    resp_f_w(end_ch - start_ch - 1 - irow + 2 * npad_wire, icol) = rs2[icol];
-                }
-            }
-            // Do FFT on wire for response // slight larger
-            // Now becomes the f and f in both time and wire domain ...
-            resp_f_w = fwd(m_dft, resp_f_w, 0);
-            // multiply them together
-            data_f_w = data_f_w * resp_f_w;
-        }
+        // multiply with the response
+        data_f_w = data_f_w * spectra->at(i);
 
         // Do inverse FFT on wire
         data_f_w = inv(m_dft, data_f_w, 0);
@@ -309,6 +196,120 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
 
 Gen::ImpactTransform::~ImpactTransform() {}
 
+Gen::ImpactTransformCache::spectra_t
+Gen::ImpactTransform::response_spectra(int ngroups, int nwires, int nticks) const
+{
+    // The response in time, truncated to the first nticks and back
+    // in frequency.
+    auto reduced = [&](const IImpactResponse::pointer& ir) {
+        Waveform::realseq_t rs_t = inv_c2r(m_dft, ir->spectrum());
+        rs_t.resize(nticks, 0);
+        return fwd_r2c(m_dft, rs_t);
+    };
+
+    ImpactTransformCache::spectra_t spectra;
+    for (int i = 0; i != ngroups; i++) {
+        const auto& map_resp = m_vec_map_resp.at(i);
+        Array::array_xxc resp_f_w = Array::array_xxc::Zero(nwires, nticks);
+        {
+            Waveform::compseq_t rs1 = reduced(map_resp.at(0));
+            for (int icol = 0; icol != nticks; icol++) {
+                resp_f_w(0, icol) = rs1[icol];
+            }
+        }
+        for (int irow = 0; irow != m_num_pad_wire; irow++) {
+            Waveform::compseq_t rs1 = reduced(map_resp.at(irow + 1));
+            Waveform::compseq_t rs2 = reduced(map_resp.at(-irow - 1));
+            for (int icol = 0; icol != nticks; icol++) {
+                resp_f_w(irow + 1, icol) = rs1[icol];
+                resp_f_w(nwires - 1 - irow, icol) = rs2[icol];
+            }
+        }
+        // Do FFT on wire for response // slight larger
+        // Now becomes the f and f in both time and wire domain ...
+        spectra.push_back(fwd(m_dft, resp_f_w, 0));
+    }
+    return spectra;
+}
+
+Gen::ImpactTransformCache::ImpactTransformCache(size_t capacity)
+  : m_capacity(capacity)
+{
+}
+
+Gen::ImpactTransformCache::spectra_ptr
+Gen::ImpactTransformCache::get(const IPlaneImpactResponse::pointer& pir,
+                               int nwires, int nticks, maker_t make)
+{
+    const key_t key(pir.get(), nwires, nticks);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            ++m_hits;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return it->second.spectra;
+        }
+        ++m_misses;
+    }
+
+    // Make outside the lock.  Concurrent misses on the same key may
+    // make the same spectra more than once.
+    auto spectra = std::make_shared<const spectra_t>(make());
+    size_t nbytes = 0;
+    for (const auto& arr : *spectra) {
+        nbytes += arr.size() * sizeof(Array::array_xxc::Scalar);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (nbytes > m_capacity or m_entries.count(key)) {
+        return spectra;
+    }
+    shrink(m_capacity - nbytes);
+    m_lru.push_front(key);
+    m_entries[key] = Entry{pir, spectra, nbytes, m_lru.begin()};
+    m_nbytes += nbytes;
+    return spectra;
+}
+
+void Gen::ImpactTransformCache::shrink(size_t capacity)
+{
+    while (m_nbytes > capacity) {
+        auto it = m_entries.find(m_lru.back());
+        m_nbytes -= it->second.nbytes;
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+}
+
+void Gen::ImpactTransformCache::set_capacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = capacity;
+    shrink(capacity);
+}
+
+size_t Gen::ImpactTransformCache::capacity() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+size_t Gen::ImpactTransformCache::nbytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbytes;
+}
+size_t Gen::ImpactTransformCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+size_t Gen::ImpactTransformCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
 Waveform::realseq_t Gen::ImpactTransform::waveform(int iwire) const
 {
     const int nsamples = m_bd.tbins().nbins();
@@ -0,0 +1,85 @@
+#include "WireCellGen/Multinomial.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace WireCell;
+
+Gen::Multinomial::Multinomial(IRandom::pointer rng, double threshold)
+  : m_rng(rng)
+  , m_uniform(rng->make_uniform(0.0, 1.0))
+  , m_normal(rng->make_normal(0.0, 1.0))
+  , m_threshold(std::min(std::max(threshold, 0.0), max_threshold))
+{
+}
+
+int Gen::Multinomial::binomial(int n, double p)
+{
+    if (n <= 0 or p <= 0) {
+        return 0;
+    }
+    if (p >= 1) {
+        return n;
+    }
+    // Keep p small so the inversion below starts at the mode side.
+    if (p > 0.5) {
+        return n - binomial(n, 1 - p);
+    }
+
+    const double mean = n * p;
+    if (mean > m_threshold) {
+        const double sigma = std::sqrt(mean * (1 - p));
+        const double k = std::round(mean + sigma * m_normal());
+        return (int) std::min(std::max(k, 0.0), (double) n);
+    }
+
+    // Exact by inversion.  With p <= 0.5 and a bounded mean, the
+    // probability of zero can not underflow.
+    const double q = 1 - p;
+    const double ratio = p / q;
+    double prob = std::pow(q, n);
+    double u = m_uniform();
+    int k = 0;
+    while (u > prob and k < n) {
+        u -= prob;
+        prob *= ratio * (n - k) / (k + 1);
+        ++k;
+    }
+    return k;
+}
+
+int Gen::Multinomial::operator()(int ntotal, float* cells, size_t n)
+{
+    double wleft = 0;
+    for (size_t ind = 0; ind < n; ++ind) {
+        wleft += cells[ind];
+    }
+    if (wleft <= 0) {
+        std::fill(cells, cells + n, 0.0f);
+        return 0;
+    }
+
+    int nleft = ntotal;
+    size_t last = 0;
+    for (size_t ind = 0; ind < n; ++ind) {
+        const double weight = cells[ind];
+        int count = 0;
+        if (weight > 0) {
+            last = ind;
+        }
+        if (nleft > 0 and weight > 0) {
+            if (weight >= wleft) {
+                count = nleft;
+            }
+            else {
+                count = binomial(nleft, weight / wleft);
+            }
+        }
+        cells[ind] = count;
+        nleft -= count;
+        wleft -= weight;
+    }
+    // Round off in the remaining weight may leave some unplaced.
+    cells[last] += nleft;
+    return ntotal;
+}
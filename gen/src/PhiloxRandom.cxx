@@ -0,0 +1,196 @@
+#include "WireCellGen/PhiloxRandom.h"
+
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Units.h"
+
+#include <cmath>
+#include <random>
+
+WIRECELL_FACTORY(PhiloxRandom, WireCell::Gen::PhiloxRandom, WireCell::IRandom, WireCell::IConfigurable)
+
+using namespace WireCell;
+
+/// Philox
+
+Gen::Philox::Philox(uint64_t seed, uint64_t stream)
+  : m_key{(uint32_t) seed, (uint32_t)(seed >> 32)}
+  , m_ctr{0, 0, (uint32_t) stream, (uint32_t)(stream >> 32)}
+  , m_block{0, 0, 0, 0}
+{
+}
+
+Gen::Philox::counter_type Gen::Philox::block(counter_type ctr, key_type key)
+{
+    const uint64_t mul0 = 0xD2511F53, mul1 = 0xCD9E8D57;
+    const uint32_t weyl0 = 0x9E3779B9, weyl1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; ++round) {
+        if (round) {
+            key[0] += weyl0;
+            key[1] += weyl1;
+        }
+        const uint64_t prod0 = mul0 * ctr[0];
+        const uint64_t prod1 = mul1 * ctr[2];
+        ctr = {(uint32_t)(prod1 >> 32) ^ ctr[1] ^ key[0], (uint32_t) prod1,
+               (uint32_t)(prod0 >> 32) ^ ctr[3] ^ key[1], (uint32_t) prod0};
+    }
+    return ctr;
+}
+
+void Gen::Philox::next_block()
+{
+    m_block = block(m_ctr, m_key);
+    if (++m_ctr[0] == 0) {
+        ++m_ctr[1];
+    }
+    m_used = 0;
+}
+
+/// PhiloxRandom
+
+Gen::PhiloxRandom::PhiloxRandom(uint64_t seed, uint64_t stream)
+  : m_seed(seed)
+  , m_stream(stream)
+  , m_engine(seed, stream)
+{
+}
+
+static uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t Gen::PhiloxRandom::stream_number(uint64_t stream, const std::vector<uint64_t>& key)
+{
+    uint64_t hash = splitmix64(stream);
+    for (auto k : key) {
+        hash = splitmix64(hash ^ k);
+    }
+    return hash;
+}
+
+void Gen::PhiloxRandom::configure(const WireCell::Configuration& cfg)
+{
+    // get<>() has no 64 bit conversion.
+    if (cfg["seed"].isNumeric()) {
+        m_seed = cfg["seed"].asUInt64();
+    }
+    std::vector<uint64_t> key;
+    for (auto jk : cfg["stream"]) {
+        key.push_back(jk.asUInt64());
+    }
+    m_stream = key.empty() ? 0 : stream_number(0, key);
+    m_engine = Philox(m_seed, m_stream);
+    m_have_normal = false;
+}
+
+WireCell::Configuration Gen::PhiloxRandom::default_configuration() const
+{
+    Configuration cfg;
+    // The 64 bit seed shared by all substreams.
+    cfg["seed"] = (Json::UInt64) m_seed;
+    // An optional key such as [run, subrun] to select the top stream.
+    cfg["stream"] = Json::arrayValue;
+    return cfg;
+}
+
+IRandom::pointer Gen::PhiloxRandom::substream(const std::vector<uint64_t>& key) const
+{
+    return std::make_shared<PhiloxRandom>(m_seed, stream_number(m_stream, key));
+}
+
+double Gen::PhiloxRandom::unit_open()
+{
+    // 53 bits from two words, shifted to exclude zero.
+    const uint64_t hi = m_engine() >> 5, lo = m_engine() >> 6;
+    return ((hi << 26) + lo + 1) * 0x1p-53;
+}
+
+int Gen::PhiloxRandom::binomial(int max, double prob)
+{
+    std::binomial_distribution<int> dist(max, prob);
+    return dist(m_engine);
+}
+IRandom::int_func Gen::PhiloxRandom::make_binomial(int max, double prob)
+{
+    return [this, dist = std::binomial_distribution<int>(max, prob)]() mutable { return dist(m_engine); };
+}
+
+int Gen::PhiloxRandom::poisson(double mean)
+{
+    std::poisson_distribution<int> dist(mean);
+    return dist(m_engine);
+}
+IRandom::int_func Gen::PhiloxRandom::make_poisson(double mean)
+{
+    return [this, dist = std::poisson_distribution<int>(mean)]() mutable { return dist(m_engine); };
+}
+
+double Gen::PhiloxRandom::normal(double mean, double sigma)
+{
+    if (m_have_normal) {
+        m_have_normal = false;
+        return mean + sigma * m_normal;
+    }
+    const double rad = std::sqrt(-2 * std::log(unit_open()));
+    const double ang = units::twopi * unit_open();
+    m_normal = rad * std::sin(ang);
+    m_have_normal = true;
+    return mean + sigma * rad * std::cos(ang);
+}
+IRandom::double_func Gen::PhiloxRandom::make_normal(double mean, double sigma)
+{
+    return [this, mean, sigma]() { return normal(mean, sigma); };
+}
+
+double Gen::PhiloxRandom::uniform(double begin, double end) { return begin + (end - begin) * (1 - unit_open()); }
+IRandom::double_func Gen::PhiloxRandom::make_uniform(double begin, double end)
+{
+    return [this, begin, end]() { return uniform(begin, end); };
+}
+
+// The std distribution takes the rate, not the mean.
+double Gen::PhiloxRandom::exponential(double mean)
+{
+    std::exponential_distribution<double> dist(1.0 / mean);
+    return dist(m_engine);
+}
+IRandom::double_func Gen::PhiloxRandom::make_exponential(double mean)
+{
+    return [this, dist = std::exponential_distribution<double>(1.0 / mean)]() mutable { return dist(m_engine); };
+}
+
+int Gen::PhiloxRandom::range(int first, int last)
+{
+    std::uniform_int_distribution<int> dist(first, last);
+    return dist(m_engine);
+}
+IRandom::int_func Gen::PhiloxRandom::make_range(int first, int last)
+{
+    return [this, dist = std::uniform_int_distribution<int>(first, last)]() mutable { return dist(m_engine); };
+}
+
+void Gen::PhiloxRandom::fill_normal(float* out, size_t n, double mean, double sigma)
+{
+    // Box-Muller with one word for each of radius and angle.
+    for (size_t ind = 0; ind < n; ind += 2) {
+        const double rad = sigma * std::sqrt(-2 * std::log((m_engine() + 1.0) * 0x1p-32));
+        const double ang = units::twopi * m_engine() * 0x1p-32;
+        out[ind] = mean + rad * std::cos(ang);
+        if (ind + 1 < n) {
+            out[ind + 1] = mean + rad * std::sin(ang);
+        }
+    }
+}
+
+void Gen::PhiloxRandom::fill_uniform(float* out, size_t n, double begin, double end)
+{
+    // 24 bits fill the float mantissa.
+    const double scale = (end - begin) * 0x1p-24;
+    for (size_t ind = 0; ind < n; ++ind) {
+        out[ind] = begin + scale * (m_engine() >> 8);
+    }
+}
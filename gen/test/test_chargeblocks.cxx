@@ -0,0 +1,95 @@
+// Check Gen::ChargeBlocks against a plain dense grid and check that
+// BinnedDiffusion_transform::get_charge_matrix() gives the same charge
+// as the unblocked get_charge_vec().
+
+#include "WireCellGen/BinnedDiffusion_transform.h"
+#include "WireCellAux/SimpleDepo.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cmath>
+
+using namespace WireCell;
+
+static void test_blocks()
+{
+    // Sizes which are not a multiple of the block sizes.
+    const int nwires = 37, nticks = 1000;
+    Gen::ChargeBlocks blocks(nwires, nticks, 16, 256);
+    Array::array_xxf want = Array::array_xxf::Zero(nwires, nticks);
+    Assert(blocks.nbytes() == 0);
+
+    for (int ind = 0; ind < 5000; ++ind) {
+        const int wire = (ind * 7) % (nwires + 4) - 2;
+        const int tick = (ind * 131) % (nticks + 20) - 10;
+        const float charge = 1 + ind % 5;
+        const bool inside = wire >= 0 and wire < nwires and tick >= 0 and tick < nticks;
+        Assert(blocks.add(wire, tick, charge) == inside);
+        if (inside) {
+            want(wire, tick) += charge;
+        }
+    }
+    Assert(blocks.dense().isApprox(want));
+    Assert(blocks.nbytes() > 0);
+
+    blocks.clear();
+    Assert(blocks.nbytes() == 0);
+    Assert(blocks.dense().isZero());
+}
+
+static void test_matrix()
+{
+    const int nwires = 20;
+    const double pitch = 3 * units::mm;
+    Pimpos pimpos(nwires, -0.5 * nwires * pitch, 0.5 * nwires * pitch);
+    Binning tbins(1000, 0, 500 * units::us);
+
+    // As used by ImpactTransform for 10 impacts per wire.
+    std::vector<int> vec_impact;
+    for (int redimp = -5; redimp <= 5; ++redimp) {
+        vec_impact.push_back(redimp);
+    }
+
+    // Depos over the plane, some partly off either edge.
+    IDepo::vector depos;
+    for (int ind = 0; ind < 40; ++ind) {
+        const Point pos(0, 0, (-0.55 + 0.028 * ind) * nwires * pitch);
+        depos.push_back(std::make_shared<Aux::SimpleDepo>((10 + 12 * ind) * units::us, pos, 1000 + 10 * ind));
+    }
+    auto fill = [&](Gen::BinnedDiffusion_transform& bd) {
+        for (const auto& depo : depos) {
+            bd.add(depo, 2 * units::us, 1.5 * units::mm);
+        }
+    };
+
+    Gen::BinnedDiffusion_transform bd_vec(pimpos, tbins);
+    fill(bd_vec);
+    std::vector<std::vector<std::tuple<int, int, double> > > vec_vec_charge(vec_impact.size());
+    bd_vec.get_charge_vec(vec_vec_charge, vec_impact);
+
+    Gen::BinnedDiffusion_transform bd_mat(pimpos, tbins);
+    fill(bd_mat);
+    std::vector<Gen::ChargeBlocks> vec_blocks(vec_impact.size(), Gen::ChargeBlocks(nwires, tbins.nbins()));
+    bd_mat.get_charge_matrix(vec_blocks, vec_impact, 0, 0);
+
+    double total = 0;
+    for (size_t igroup = 0; igroup < vec_impact.size(); ++igroup) {
+        Array::array_xxf want = Array::array_xxf::Zero(nwires, tbins.nbins());
+        for (const auto& [wire, tick, charge] : vec_vec_charge[igroup]) {
+            if (tick >= 0 and tick < tbins.nbins()) {
+                want(wire, tick) += charge;
+            }
+        }
+        const auto got = vec_blocks[igroup].dense();
+        Assert(std::abs(got.sum() - want.sum()) <= 1e-5 * std::abs(want.sum()) + 1e-3);
+        Assert((got - want).abs().maxCoeff() <= 1e-5 * want.abs().maxCoeff() + 1e-6);
+        total += want.sum();
+    }
+    Assert(total > 0);
+}
+
+int main()
+{
+    test_blocks();
+    test_matrix();
+    return 0;
+}
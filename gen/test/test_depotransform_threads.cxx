@@ -0,0 +1,81 @@
+// Check Gen::DepoTransform gives the same frame when its planes are
+// transformed serially and concurrently, with and without
+// fluctuation.
+#include "WireCellGen/DepoTransform.h"
+#include "WireCellAux/SimpleDepo.h"
+#include "WireCellAux/SimpleDepoSet.h"
+#include "WireCellIface/IDFT.h"
+#include "WireCellUtil/Testing.h"
+
+#include "anode_loader.h"
+
+#include <map>
+
+using namespace WireCell;
+
+static IFrame::pointer transform(const IDepoSet::pointer& in, int nthreads, const std::string& rng)
+{
+    Gen::DepoTransform dt;
+    auto cfg = dt.default_configuration();
+    cfg["anode"] = "AnodePlane:0";
+    cfg["nthreads"] = nthreads;
+    cfg["readout_time"] = 1 * units::ms;
+    cfg["fluctuate"] = !rng.empty();
+    cfg["rng"] = rng;
+    for (int iplane = 0; iplane < 3; ++iplane) {
+        cfg["pirs"].append(String::format("PlaneImpactResponse:%d", iplane));
+    }
+    dt.configure(cfg);
+
+    IFrame::pointer out;
+    Assert(dt(in, out));
+    Assert(out);
+    return out;
+}
+
+static std::map<int, std::pair<int, ITrace::ChargeSequence>> bychan(const IFrame::pointer& frame)
+{
+    std::map<int, std::pair<int, ITrace::ChargeSequence>> ret;
+    for (const auto& trace : *frame->traces()) {
+        Assert(ret.find(trace->channel()) == ret.end());
+        ret[trace->channel()] = std::make_pair(trace->tbin(), trace->charge());
+    }
+    return ret;
+}
+
+int main()
+{
+    anode_loader("uboone");
+    PluginManager::instance().add("WireCellAux");
+    Factory::lookup_tn<IDFT>("FftwDFT");
+
+    for (int iplane = 0; iplane < 3; ++iplane) {
+        auto icfg = Factory::lookup_tn<IConfigurable>(String::format("PlaneImpactResponse:%d", iplane));
+        auto cfg = icfg->default_configuration();
+        cfg["plane"] = iplane;
+        cfg["nticks"] = 2000;
+        icfg->configure(cfg);
+    }
+    for (std::string name : {"a", "b"}) {
+        auto icfg = Factory::lookup<IConfigurable>("PhiloxRandom", name);
+        icfg->configure(icfg->default_configuration());
+    }
+
+    // A short track just behind the response plane.
+    IDepo::vector depos;
+    for (int ind = 0; ind < 100; ++ind) {
+        const Point pos(1 * units::m, (ind - 50) * units::cm, 2 * units::m + ind * units::cm);
+        depos.push_back(std::make_shared<Aux::SimpleDepo>(100 * units::us + ind * units::us, pos, 5000, nullptr,
+                                                          1 * units::mm, 1 * units::mm));
+    }
+    auto in = std::make_shared<Aux::SimpleDepoSet>(0, depos);
+
+    auto serial = bychan(transform(in, 1, ""));
+    Assert(!serial.empty());
+    Assert(serial == bychan(transform(in, 3, "")));
+
+    auto fserial = bychan(transform(in, 1, "PhiloxRandom:a"));
+    Assert(fserial == bychan(transform(in, 3, "PhiloxRandom:b")));
+    Assert(fserial != serial);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Check the bulk Digitizer kernel against the per-sample one and
+// that its output survives conversion to a compact int16 tensor.
+#include "WireCellGen/Digitizer.h"
+#include "WireCellAux/SimpleTrace.h"
+#include "WireCellAux/TensorDMframe.h"
+#include "WireCellUtil/Array.h"
+#include "WireCellUtil/Testing.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace WireCell;
+
+int main()
+{
+    // Unconfigured, the digitizer has its nominal 12 bit parameters.
+    Gen::Digitizer digi;
+
+    const std::vector<float> baselines{900 * units::mV, 900 * units::mV, 200 * units::mV};
+    const size_t nticks = 10000;
+    const float vlo = -1.5 * units::volt, vhi = 2.5 * units::volt;
+
+    Array::array_xxf volts(baselines.size(), nticks);
+    for (size_t irow = 0; irow < baselines.size(); ++irow) {
+        for (size_t icol = 0; icol < nticks; ++icol) {
+            volts(irow, icol) = vlo + (vhi - vlo) * icol / (nticks - 1);
+        }
+    }
+
+    ITrace::vector traces;
+    for (size_t irow = 0; irow < baselines.size(); ++irow) {
+        std::vector<float> wave(nticks);
+        for (size_t icol = 0; icol < nticks; ++icol) {
+            wave[icol] = volts(irow, icol);
+        }
+        digi.digitize(wave.data(), nticks, baselines[irow]);
+
+        for (size_t icol = 0; icol < nticks; ++icol) {
+            // As in the per-sample path, the sum is taken in double.
+            const double want = digi.digitize((double) volts(irow, icol) + baselines[irow]);
+            if (wave[icol] != want) {
+                std::cerr << "row " << irow << " col " << icol << ": want " << want << " got " << wave[icol]
+                          << "\n";
+            }
+            Assert(wave[icol] == want);
+        }
+        // The ramp spans past both ends of the full scale.
+        Assert(wave.front() == 0);
+        Assert(wave.back() == 4095);
+        traces.push_back(std::make_shared<Aux::SimpleTrace>(irow, 0, wave));
+    }
+
+    // As made by FrameTensor with "digitize": true.
+    auto ten = Aux::TensorDM::as_trace_tensor(traces, "frames/0/traces/0", true);
+    Assert(ten->dtype() == "i2");
+    Assert(ten->shape() == ITensor::shape_t({baselines.size(), nticks}));
+    const int16_t* adc = (const int16_t*) ten->data();
+    for (size_t irow = 0; irow < traces.size(); ++irow) {
+        const auto& wave = traces[irow]->charge();
+        for (size_t icol = 0; icol < nticks; ++icol) {
+            Assert(adc[irow * nticks + icol] == wave[icol]);
+        }
+    }
+    return 0;
+}
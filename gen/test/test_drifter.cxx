@@ -0,0 +1,109 @@
+// Check Gen::Drifter streaming and batch modes give the same depos
+// and that both keep time order across drift regions.  Check that
+// batch mode with fluctuations does not depend on the thread count
+// but does depend on the depo set ident and the drifter stream id.
+#include "WireCellGen/Drifter.h"
+#include "WireCellUtil/PluginManager.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Testing.h"
+#include "WireCellAux/SimpleDepo.h"
+
+#include <algorithm>
+
+using namespace WireCell;
+
+static bool by_time(const IDepo::pointer& a, const IDepo::pointer& b) { return a->time() < b->time(); }
+
+int main()
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellGen");
+    {
+        auto icfg = Factory::lookup<IConfigurable>("Random");
+        icfg->configure(icfg->default_configuration());
+    }
+
+    for (std::string name : {"a", "b"}) {
+        auto icfg = Factory::lookup<IConfigurable>("PhiloxRandom", name);
+        icfg->configure(icfg->default_configuration());
+    }
+
+    // Two regions on each side of x=0 so depos alternate between them
+    // and all contribute to every flush.
+    auto make_drifter = [](bool fluctuate, const std::string& rng, int stream_id = 0) {
+        auto drifter = std::make_shared<Gen::Drifter>();
+        auto cfg = drifter->default_configuration();
+        for (double sign : {-1.0, 1.0}) {
+            for (double xoff : {0.0, 1.0}) {
+                Configuration jxr;
+                jxr["anode"] = sign * (xoff + 0.1) * units::m;
+                jxr["cathode"] = sign * (xoff + 1.0) * units::m;
+                cfg["xregions"].append(jxr);
+            }
+        }
+        cfg["fluctuate"] = fluctuate;
+        cfg["rng"] = rng;
+        cfg["stream_id"] = stream_id;
+        drifter->configure(cfg);
+        return drifter;
+    };
+    auto drifter = make_drifter(false, "Random");
+
+    IDepo::vector depos;
+    const int ndepos = 10000;
+    for (int ind = 0; ind < ndepos; ++ind) {
+        const double x = ((ind * 7919) % 3800 - 1900) * units::mm;
+        depos.push_back(std::make_shared<Aux::SimpleDepo>(ind * units::us, Point(x, 0, 0), 1000));
+    }
+
+    IDepo::vector streamed;
+    for (const auto& depo : depos) {
+        IDrifter::output_queue outq;
+        (*drifter)(depo, outq);
+        streamed.insert(streamed.end(), outq.begin(), outq.end());
+    }
+    IDrifter::output_queue outq;
+    (*drifter)(nullptr, outq);
+    Assert(outq.back() == nullptr);
+    streamed.insert(streamed.end(), outq.begin(), outq.end() - 1);
+
+    auto batched = drifter->drift(depos, 0);
+
+    Assert(!streamed.empty());
+    Assert(streamed.size() == batched.size());
+    Assert(std::is_sorted(streamed.begin(), streamed.end(), by_time));
+    Assert(std::is_sorted(batched.begin(), batched.end(), by_time));
+    for (size_t ind = 0; ind < batched.size(); ++ind) {
+        Assert(streamed[ind]->time() == batched[ind]->time());
+        Assert(streamed[ind]->pos() == batched[ind]->pos());
+        Assert(streamed[ind]->charge() == batched[ind]->charge());
+    }
+
+    auto serial = make_drifter(true, "PhiloxRandom:a")->drift(depos, 7, 1);
+    auto threaded = make_drifter(true, "PhiloxRandom:b")->drift(depos, 7, 4);
+    Assert(serial.size() == batched.size());
+    Assert(serial.size() == threaded.size());
+    bool fluctuated = false;
+    for (size_t ind = 0; ind < serial.size(); ++ind) {
+        Assert(serial[ind]->time() == threaded[ind]->time());
+        Assert(serial[ind]->charge() == threaded[ind]->charge());
+        fluctuated = fluctuated or serial[ind]->charge() != batched[ind]->charge();
+    }
+    Assert(fluctuated);
+
+    // Another depo set or another drifter on the same generator
+    // must not repeat the fluctuations.
+    auto differs = [&](const IDepo::vector& other) {
+        Assert(other.size() == serial.size());
+        for (size_t ind = 0; ind < serial.size(); ++ind) {
+            if (serial[ind]->charge() != other[ind]->charge()) {
+                return true;
+            }
+        }
+        return false;
+    };
+    Assert(differs(make_drifter(true, "PhiloxRandom:a")->drift(depos, 8, 1)));
+    Assert(differs(make_drifter(true, "PhiloxRandom:a", 1)->drift(depos, 7, 1)));
+    Assert(!differs(make_drifter(true, "PhiloxRandom:a")->drift(depos, 7, 1)));
+    return 0;
+}
@@ -1,11 +1,13 @@
 #include "WireCellAux/Testing.h"
 
+#include "WireCellGen/EmpiricalNoiseModel.h"
 #include "WireCellIface/IChannelSpectrum.h"
 #include "WireCellIface/IChannelStatus.h"
 
 #include "WireCellUtil/Stream.h"
 #include "WireCellUtil/String.h"
 #include "WireCellUtil/Persist.h"
+#include "WireCellUtil/Testing.h"
 
 #include <boost/crc.hpp>
 
@@ -52,8 +54,8 @@ int main(int argc, char* argv[])
 {
     // Testing::loginit(argv[0]);
 
-    auto rng = Testing::get_random();
-    auto dft = Testing::get_dft();
+    auto rng = Aux::Testing::get_random();
+    auto dft = Aux::Testing::get_dft();
 
     Stream::filtering_ostream out;
     // fixme: need PR #163 merged to save as .npz
@@ -65,8 +67,8 @@ int main(int argc, char* argv[])
 
     size_t nsamples = 2000;     // explicitly NOT an FFT "best" length
 
-    auto anodes = Testing::anodes("pdsp");
-    Testing::get_default<IChannelStatus>("StaticChannelStatus");
+    auto anodes = Aux::Testing::anodes("pdsp");
+    Aux::Testing::get_default<IChannelStatus>("StaticChannelStatus");
     {
         auto ienm = Factory::lookup<IConfigurable>("EmpiricalNoiseModel");
         auto cfg = ienm->default_configuration();
@@ -98,8 +100,14 @@ int main(int argc, char* argv[])
         }
         auto key = crc.checksum();
         amps[key] = spec;
+
+        // The view is of the same shared storage.
+        auto span = enm->channel_spectrum_span(chid);
+        Assert(span.data() == spec.data() and span.size() == spec.size());
     }
     std::cerr << "Got " << amps.size() << " unique spectra\n";
+    auto genm = std::dynamic_pointer_cast<Gen::EmpiricalNoiseModel>(enm);
+    Assert(genm and genm->nspectra() == amps.size());
     int count=0;
     for (const auto& [key,amp] : amps) {
         std::cerr << "Writing spec of size: " << amp.size() << "\n";
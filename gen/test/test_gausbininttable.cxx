@@ -0,0 +1,42 @@
+// Check GausBinintTable against exact GausDesc::binint().
+
+#include "WireCellGen/GaussianDiffusion.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace WireCell;
+
+int main()
+{
+    Gen::GausBinintTable table(0.001, 1000);
+
+    const double step = 0.5 * units::us;
+    double maxdiff = 0;
+    for (int ind = 0; ind < 1000; ++ind) {
+        // A few sigma values and centers that repeat modulo the bin.
+        const double sigma = (1.0 + (ind % 4)) * 0.7 * step;
+        const double center = (100 + ind % 7) * step + (ind % 50) * 0.02 * step;
+        const Gen::GausDesc gd(center, sigma);
+        const double start = std::floor((center - 3 * sigma) / step) * step;
+        const int nbins = std::ceil((center + 3 * sigma - start) / step);
+
+        auto exact = gd.binint(start, step, nbins);
+        auto approx = table.binint(gd, start, step, nbins);
+        Assert(exact.size() == approx.size());
+        for (int ibin = 0; ibin < nbins; ++ibin) {
+            maxdiff = std::max(maxdiff, std::abs(exact[ibin] - approx[ibin]));
+        }
+    }
+    std::cerr << "entries=" << table.size() << " hits=" << table.hits() << " misses=" << table.misses()
+              << " maxdiff=" << maxdiff << "\n";
+    Assert(maxdiff < 1e-3);
+    Assert(table.hits() > 0);
+    Assert(table.hits() + table.misses() == 1000);
+
+    // Point sources are passed through.
+    auto point = table.binint(Gen::GausDesc(1.0, 0.0), 0.0, 1.0, 1);
+    Assert(point.size() == 1 and point[0] == 1.0);
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Check the LRU and capacity bookkeeping of ImpactTransformCache.
+
+#include "WireCellGen/ImpactTransform.h"
+#include "WireCellUtil/Testing.h"
+
+#include <iostream>
+
+using namespace WireCell;
+using spectra_t = Gen::ImpactTransformCache::spectra_t;
+
+int main()
+{
+    // The cache only uses the PIR as an identity.
+    IPlaneImpactResponse::pointer pir;
+
+    int nmade = 0;
+    auto maker = [&](int nwires, int nticks) {
+        return [&, nwires, nticks]() {
+            ++nmade;
+            return spectra_t(2, Array::array_xxc::Constant(nwires, nticks, nmade));
+        };
+    };
+    const size_t entry_bytes = 2 * 10 * 100 * sizeof(Array::array_xxc::Scalar);
+
+    Gen::ImpactTransformCache cache(2 * entry_bytes);
+    auto a = cache.get(pir, 10, 100, maker(10, 100));
+    auto a2 = cache.get(pir, 10, 100, maker(10, 100));
+    Assert(a == a2);
+    Assert(nmade == 1);
+    Assert(cache.nbytes() == entry_bytes);
+
+    auto b = cache.get(pir, 100, 10, maker(100, 10));
+    Assert(nmade == 2);
+    Assert(b->at(0).rows() == 100);
+    Assert(cache.nbytes() == 2 * entry_bytes);
+
+    // Touch "a" so that "b" is dropped to make room for "c".
+    cache.get(pir, 10, 100, maker(10, 100));
+    cache.get(pir, 20, 50, maker(20, 50));
+    Assert(nmade == 3);
+    Assert(cache.nbytes() == 2 * entry_bytes);
+    cache.get(pir, 10, 100, maker(10, 100));
+    Assert(nmade == 3);
+    cache.get(pir, 100, 10, maker(100, 10));
+    Assert(nmade == 4);
+
+    // Too large to cache, still returned.
+    auto big = cache.get(pir, 100, 100, maker(100, 100));
+    Assert(big->size() == 2);
+    Assert(cache.nbytes() == 2 * entry_bytes);
+
+    std::cerr << "hits=" << cache.hits() << " misses=" << cache.misses() << "\n";
+    Assert(cache.hits() == 3);
+    Assert(cache.misses() == 5);
+
+    cache.set_capacity(0);
+    Assert(cache.nbytes() == 0);
+    cache.get(pir, 10, 100, maker(10, 100));
+    Assert(cache.nbytes() == 0);
+    return 0;
+}
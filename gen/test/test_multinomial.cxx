@@ -0,0 +1,76 @@
+// Check Gen::Multinomial preserves totals and has binomial moments
+// in both its exact and approximate regimes.
+
+#include "WireCellGen/Multinomial.h"
+#include "WireCellGen/Random.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace WireCell;
+
+// Return the mean and variance of the count in the cell.
+static std::pair<double, double> moments(Gen::Multinomial& mn, int ntotal, const std::vector<float>& weights,
+                                         size_t cell, int ntries)
+{
+    double sum = 0, sum2 = 0;
+    std::vector<float> cells;
+    for (int count = 0; count < ntries; ++count) {
+        cells = weights;
+        int got = mn(ntotal, cells.data(), cells.size());
+        Assert(got == ntotal);
+        double tot = 0;
+        for (auto c : cells) {
+            Assert(c >= 0);
+            Assert(c == std::round(c));
+            tot += c;
+        }
+        Assert(tot == ntotal);
+        sum += cells[cell];
+        sum2 += cells[cell] * cells[cell];
+    }
+    const double mean = sum / ntries;
+    return std::make_pair(mean, sum2 / ntries - mean * mean);
+}
+
+int main()
+{
+    auto rng = std::make_shared<Gen::Random>();
+    rng->configure(rng->default_configuration());
+
+    // Weights need not be normalized and may include zeros.
+    const std::vector<float> weights{0, 1, 2, 4, 2, 1, 0};
+    const double wsum = 10;
+    const size_t cell = 3;
+    const double p = weights[cell] / wsum;
+    const int ntries = 20000;
+
+    for (int ntotal : {10, 100, 10000}) {
+        for (double threshold : {0.0, 30.0, Gen::Multinomial::max_threshold}) {
+            Gen::Multinomial mn(rng, threshold);
+            auto mv = moments(mn, ntotal, weights, cell, ntries);
+            const double mean = ntotal * p;
+            const double var = ntotal * p * (1 - p);
+            std::cerr << "ntotal=" << ntotal << " threshold=" << threshold << " mean=" << mv.first << " (" << mean
+                      << ") var=" << mv.second << " (" << var << ")\n";
+            Assert(std::abs(mv.first - mean) < 5 * std::sqrt(var / ntries));
+            Assert(std::abs(mv.second / var - 1) < 0.1);
+        }
+    }
+
+    // Zero weight cells get nothing and all zero weights gives zero.
+    Gen::Multinomial mn(rng);
+    std::vector<float> cells = weights;
+    mn(1000, cells.data(), cells.size());
+    Assert(cells.front() == 0 and cells.back() == 0);
+    std::vector<float> zeros(5, 0);
+    Assert(mn(1000, zeros.data(), zeros.size()) == 0);
+
+    // Edge cases of the binomial.
+    Assert(mn.binomial(0, 0.5) == 0);
+    Assert(mn.binomial(100, 0) == 0);
+    Assert(mn.binomial(100, 1) == 100);
+    return 0;
+}
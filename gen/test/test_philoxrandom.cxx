@@ -0,0 +1,100 @@
+// Check Gen::PhiloxRandom against known answers, for reproducible
+// substreams and for the moments of its bulk distributions.
+
+#include "WireCellGen/PhiloxRandom.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+
+static void moments(const std::vector<float>& vals, double& mean, double& var)
+{
+    double sum = 0, sum2 = 0;
+    for (auto v : vals) {
+        sum += v;
+        sum2 += v * v;
+    }
+    mean = sum / vals.size();
+    var = sum2 / vals.size() - mean * mean;
+}
+
+int main()
+{
+    // Known answer tests from the Random123 distribution.
+    {
+        auto got = Gen::Philox::block({0, 0, 0, 0}, {0, 0});
+        Assert(got == Gen::Philox::counter_type({0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+        got = Gen::Philox::block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+        Assert(got == Gen::Philox::counter_type({0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+        got = Gen::Philox::block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+        Assert(got == Gen::Philox::counter_type({0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+    }
+
+    Gen::PhiloxRandom top(42);
+    const size_t nchannels = 16, nsamples = 10000;
+
+    // Fill per-channel substreams serially and from threads.
+    std::vector<std::vector<float> > serial(nchannels, std::vector<float>(nsamples));
+    std::vector<std::vector<float> > threaded = serial;
+    for (size_t ch = 0; ch < nchannels; ++ch) {
+        top.substream({1, 0, ch})->fill_normal(serial[ch].data(), nsamples);
+    }
+    std::vector<std::thread> workers;
+    for (size_t ch = nchannels; ch > 0; --ch) {
+        workers.emplace_back([&, ch]() { top.substream({1, 0, ch - 1})->fill_normal(threaded[ch - 1].data(), nsamples); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    Assert(serial == threaded);
+
+    // Distinct keys and seeds give distinct streams.
+    Assert(serial[0] != serial[1]);
+    std::vector<float> other(nsamples);
+    Gen::PhiloxRandom(43).substream({1, 0, 0})->fill_normal(other.data(), nsamples);
+    Assert(other != serial[0]);
+
+    double mean = 0, var = 0;
+    moments(serial[3], mean, var);
+    std::cerr << "normal: mean=" << mean << " var=" << var << "\n";
+    Assert(std::abs(mean) < 0.05 and std::abs(var - 1) < 0.05);
+
+    std::vector<float> uni(nsamples);
+    top.fill_uniform(uni.data(), nsamples, 2.0, 4.0);
+    for (auto u : uni) {
+        Assert(u >= 2.0 and u <= 4.0);
+    }
+    moments(uni, mean, var);
+    std::cerr << "uniform: mean=" << mean << " var=" << var << "\n";
+    Assert(std::abs(mean - 3) < 0.02 and std::abs(var - 1.0 / 3) < 0.02);
+
+    // The scalar methods.
+    double sum = 0;
+    for (size_t ind = 0; ind < nsamples; ++ind) {
+        sum += top.normal(10, 2) + top.poisson(5) + top.binomial(10, 0.5);
+    }
+    std::cerr << "scalar: mean=" << sum / nsamples << "\n";
+    Assert(std::abs(sum / nsamples - 20) < 0.2);
+
+    // Exponential takes the mean.
+    std::vector<float> expo(nsamples);
+    auto gen = top.make_exponential(4.0);
+    for (size_t ind = 0; ind < nsamples; ++ind) {
+        expo[ind] = ind % 2 ? gen() : top.exponential(4.0);
+    }
+    moments(expo, mean, var);
+    std::cerr << "exponential: mean=" << mean << " var=" << var << "\n";
+    Assert(std::abs(mean - 4) < 0.2 and std::abs(var - 16) < 2);
+
+    // Configuration resets the stream.
+    Gen::PhiloxRandom conf;
+    auto cfg = conf.default_configuration();
+    cfg["seed"] = 42;
+    conf.configure(cfg);
+    Assert(conf.uniform(0, 1) == Gen::PhiloxRandom(42).uniform(0, 1));
+    return 0;
+}
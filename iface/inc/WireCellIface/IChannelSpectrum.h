@@ -8,6 +8,13 @@
 
 #include "WireCellUtil/IComponent.h"
 
+#include "WireCellUtil/BuildConfig.h"
+#ifdef HAVE_BOOST_CORE_SPAN_HPP
+#include "boost/core/span.hpp"
+#else
+#include "WireCellUtil/boost/core/span.hpp"
+#endif
+
 namespace WireCell {
 
     class IChannelSpectrum : virtual public IComponent<IChannelSpectrum> {
@@ -20,6 +27,19 @@ namespace WireCell {
         /// Return a regularly sampled spectrum for the channel ID.
         virtual const amplitude_t& channel_spectrum(int chid) const = 0;
 
+        /// A view of a spectrum held by the model.
+        typedef boost::span<const float> amplitude_span_t;
+
+        /// Return a view of the spectrum for the channel ID.  It is
+        /// valid as long as the model.  Models which share storage
+        /// between channels may override this to avoid any lookup
+        /// beyond that for the channel.
+        virtual amplitude_span_t channel_spectrum_span(int chid) const
+        {
+            const auto& amp = channel_spectrum(chid);
+            return amplitude_span_t(amp.data(), amp.size());
+        }
+
     };
 }  // namespace WireCell
 
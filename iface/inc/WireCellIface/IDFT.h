@@ -37,6 +37,18 @@ namespace WireCell {
         There is also a special rank=0 DFT on rank=2 arrays which is
         more commonly known as a "matrix transpose".
 
+        Each of the six DFT methods has a real-valued counterpart.
+        The "fwd*_r2c" methods take real arrays and produce only the
+        non-negative frequency half of the Hermitian-symmetric
+        spectrum.  The "inv*_c2r" methods take such a half spectrum
+        and produce real arrays.  Along the transformed dimension of
+        size n, the half spectrum has n/2+1 elements.  For 2d, the
+        column dimension is halved.  The nrows and ncols arguments
+        always give the shape of the real array.  For example, the
+        spectrum from fwd1b_r2c() with axis=0 has shape (nrows/2+1,
+        ncols).  These do roughly half the work and use half the
+        memory of their complex counterparts.
+
         Requirements on implementations:
 
         - Forward transforms SHALL NOT apply normalization.
@@ -53,6 +65,10 @@ namespace WireCell {
           of 1d calls and a implementation MAY override these (for
           example, if implementation can exploit batch optimization).
 
+        - The IDFT interface provides r2c/c2r methods implemented in
+          terms of the complex methods and an implementation SHOULD
+          override these with native real transforms.
+
         - Implementation SHALL allow safe concurrent calls to methods
           by different threads of execution.
 
@@ -62,7 +78,8 @@ namespace WireCell {
           at least as large as indicated by accompanying size arguments.
 
         - Input and output arrays MUST either be non-overlapping in
-          memory or MUST be identical.
+          memory or MUST be identical.  The r2c/c2r methods require
+          non-overlapping arrays.
 
         Notes: 
 
@@ -115,6 +132,34 @@ namespace WireCell {
                    int nrows, int ncols) const = 0;
 
 
+        // 1d real
+
+        virtual
+        void fwd1d_r2c(const scalar_t* in, complex_t* out, int size) const;
+
+        virtual
+        void inv1d_c2r(const complex_t* in, scalar_t* out, int size) const;
+
+        // 1b real
+
+        virtual
+        void fwd1b_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols, int axis) const;
+
+        virtual
+        void inv1b_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols, int axis) const;
+
+        // 2d real
+
+        virtual
+        void fwd2d_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols) const;
+
+        virtual
+        void inv2d_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols) const;
+
         // Fill "out" with the transpose of "in", may be in-place.
         // The nrows/ncols refers to the shape of the input.
         virtual
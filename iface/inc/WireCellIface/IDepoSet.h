@@ -3,8 +3,29 @@
 
 #include "WireCellIface/IDepo.h"
 
+#include <vector>
+
 namespace WireCell {
 
+    /** Depositions held as columns, one row per depo.
+
+        Prior depos are also rows and are referred to by their row
+        index.  The rows which are members of the set are listed in
+        "active" in the same order as IDepoSet::depos().
+     */
+    struct DepoColumns {
+        std::vector<double> time, charge, energy;
+        std::vector<double> x, y, z;
+        std::vector<double> extent_long, extent_tran;
+        std::vector<int> id, pdg;
+        /// Row of the prior depo or -1 if none.
+        std::vector<int> prior;
+        /// Rows which are members of the set.
+        std::vector<size_t> active;
+
+        size_t size() const { return time.size(); }
+    };
+
     /** An interface to information about a deposition of charge.
      */
     class IDepoSet : public IData<IDepoSet> {
@@ -16,6 +37,11 @@ namespace WireCell {
 
         /// Return the depositions in this set.
         virtual IDepo::shared_vector depos() const = 0;
+
+        /// Return the depositions in columnar form or nullptr if the
+        /// set does not hold them that way.  Consumers which only
+        /// need depo attributes may use this to avoid depos().
+        virtual const DepoColumns* columns() const { return nullptr; }
     };
 }  // namespace WireCell
 
@@ -17,13 +17,23 @@
     Note, to gain any speed up, the IRandom implementation must
     explicitly implement these "callable" methods.  
 
+    The "bulk" methods fill an array with values.  By default they
+    call a "callable" but an implementation may provide faster ones.
+
+    An implementation may provide independent "substreams" keyed by
+    a sequence of numbers such as (event, anode, channel).  A
+    substream depends only on the seed of its parent and the key so
+    work split across threads may be reproducible regardless of the
+    order in which it is done.
  */
 
 #ifndef WIRECELL_IRANDOM
 #define WIRECELL_IRANDOM
 
 #include "WireCellUtil/IComponent.h"
+#include <cstdint>
 #include <functional>
+#include <vector>
 
 namespace WireCell {
 
@@ -57,6 +67,17 @@ namespace WireCell {
         /// Sample a uniform integer range.
         virtual int range(int first, int last) = 0;
         virtual int_func make_range(int first, int last);
+
+        /// Fill n values sampled from a normal distribution.
+        virtual void fill_normal(float* out, size_t n, double mean = 0.0, double sigma = 1.0);
+
+        /// Fill n values sampled from a uniform distribution.
+        virtual void fill_uniform(float* out, size_t n, double begin = 0.0, double end = 1.0);
+
+        /// Return an independent generator determined by the seed
+        /// of this one and the key or nullptr if substreams are not
+        /// supported.
+        virtual pointer substream(const std::vector<uint64_t>& key) const;
     };
 
 }  // namespace WireCell
@@ -1,5 +1,6 @@
 #include "WireCellIface/IDFT.h"
 
+#include <algorithm>
 #include <vector>
 #include <utility>              // std::swap since c++11
 
@@ -42,6 +43,85 @@ void IDFT::inv1b(const complex_t* in, complex_t* out,
     }
 }
 
+// Default real transforms go through the complex ones.  They give
+// correct results but none of the savings.  Implementations should
+// override with native r2c/c2r transforms.
+
+void IDFT::fwd1d_r2c(const scalar_t* in, complex_t* out, int size) const
+{
+    std::vector<complex_t> cin(in, in + size), cout(size);
+    fwd1d(cin.data(), cout.data(), size);
+    std::copy(cout.begin(), cout.begin() + size / 2 + 1, out);
+}
+
+void IDFT::inv1d_c2r(const complex_t* in, scalar_t* out, int size) const
+{
+    const int nhalf = size / 2 + 1;
+    std::vector<complex_t> cin(size), cout(size);
+    std::copy(in, in + nhalf, cin.begin());
+    for (int ind = nhalf; ind < size; ++ind) {
+        cin[ind] = std::conj(in[size - ind]);
+    }
+    inv1d(cin.data(), cout.data(), size);
+    for (int ind = 0; ind < size; ++ind) {
+        out[ind] = std::real(cout[ind]);
+    }
+}
+
+void IDFT::fwd1b_r2c(const scalar_t* in, complex_t* out,
+                     int nrows, int ncols, int axis) const
+{
+    if (axis) {
+        const int nhalf = ncols / 2 + 1;
+        for (int irow = 0; irow < nrows; ++irow) {
+            fwd1d_r2c(in + irow * ncols, out + irow * nhalf, ncols);
+        }
+    }
+    else {
+        const int nhalf = nrows / 2 + 1;
+        std::vector<scalar_t> tin(nrows * ncols);
+        std::vector<complex_t> tout(ncols * nhalf);
+        this->transpose(in, tin.data(), nrows, ncols);
+        this->fwd1b_r2c(tin.data(), tout.data(), ncols, nrows, 1);
+        this->transpose(tout.data(), out, ncols, nhalf);
+    }
+}
+
+void IDFT::inv1b_c2r(const complex_t* in, scalar_t* out,
+                     int nrows, int ncols, int axis) const
+{
+    if (axis) {
+        const int nhalf = ncols / 2 + 1;
+        for (int irow = 0; irow < nrows; ++irow) {
+            inv1d_c2r(in + irow * nhalf, out + irow * ncols, ncols);
+        }
+    }
+    else {
+        const int nhalf = nrows / 2 + 1;
+        std::vector<complex_t> tin(nhalf * ncols);
+        this->transpose(in, tin.data(), nhalf, ncols);
+        this->inv1b_c2r(tin.data(), out, ncols, nrows, 1);
+        this->transpose(out, out, ncols, nrows);
+    }
+}
+
+void IDFT::fwd2d_r2c(const scalar_t* in, complex_t* out,
+                     int nrows, int ncols) const
+{
+    const int nhalf = ncols / 2 + 1;
+    fwd1b_r2c(in, out, nrows, ncols, 1);
+    fwd1b(out, out, nrows, nhalf, 0);
+}
+
+void IDFT::inv2d_c2r(const complex_t* in, scalar_t* out,
+                     int nrows, int ncols) const
+{
+    const int nhalf = ncols / 2 + 1;
+    std::vector<complex_t> tmp(nrows * nhalf);
+    inv1b(in, tmp.data(), nrows, nhalf, 0);
+    inv1b_c2r(tmp.data(), out, nrows, ncols, 1);
+}
+
 // Trivial default transpose.  Implementations, please override if you
 // can offer something faster.
 
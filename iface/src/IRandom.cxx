@@ -41,3 +41,20 @@ IRandom::int_func IRandom::make_range(int first, int last)
     return std::bind(&IRandom::range, this, first, last);
 }
 
+void IRandom::fill_normal(float* out, size_t n, double mean, double sigma)
+{
+    auto gen = make_normal(mean, sigma);
+    for (size_t ind = 0; ind < n; ++ind) {
+        out[ind] = gen();
+    }
+}
+
+void IRandom::fill_uniform(float* out, size_t n, double begin, double end)
+{
+    auto gen = make_uniform(begin, end);
+    for (size_t ind = 0; ind < n; ++ind) {
+        out[ind] = gen();
+    }
+}
+
+IRandom::pointer IRandom::substream(const std::vector<uint64_t>& key) const { return nullptr; }
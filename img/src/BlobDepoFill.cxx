@@ -268,7 +268,7 @@ bool Img::BlobDepoFill::operator()(const input_tuple_type& intup,
         // plane "pimpos" coordinate system.
         IDepo::vector depos;
         std::vector<double> dwcenter;
-        auto mydepos = sensitive(*(ideposet->depos()), ianodeface);
+        auto mydepos = sensitive(ideposet, ianodeface);
         log->debug("call={} face={} nblobs={} ndepos={}",
                    m_count, bdescvector.size(), mydepos.size());
         for (const auto& maybe : mydepos) {
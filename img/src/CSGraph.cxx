@@ -64,13 +64,14 @@ graph_t CS::solve(const graph_t& csg, const SolveParams& params, const bool verb
         blob_descs_out(desc_out);        
     }
 
+    // The measure covariance is diagonal so only its variances are kept.
     double_vector_t measure = double_vector_t::Zero(nmeas);
-    double_matrix_t mcov = double_matrix_t::Zero(nmeas, nmeas);
+    double_vector_t mvar = double_vector_t::Zero(nmeas);
     for (size_t mind=0; mind<nmeas; ++mind) {
         const auto& meas_in = csg[meas_descs.collection[mind]];
         const auto valerr = meas_in.value;
         measure(mind) = valerr.value();
-        mcov(mind, mind) = valerr.uncertainty()*valerr.uncertainty();
+        mvar(mind) = valerr.uncertainty()*valerr.uncertainty();
         /// TODO: rm debug info
         // if (verbose) {
         //     SPDLOG_INFO("val {} unc {}", valerr.value(), valerr.uncertainty());
@@ -78,7 +79,7 @@ graph_t CS::solve(const graph_t& csg, const SolveParams& params, const bool verb
         auto desc_out = boost::add_vertex(meas_in, csg_out);
         meas_descs_out(desc_out);        
     }
-    if (params.whiten and mcov.sum() == 0.0) {
+    if (params.whiten and mvar.sum() == 0.0) {
         // std::cerr << "zero measure covariance from " << boost::num_vertices(csg) << " node graph\n";
         return csg_out;
     }
@@ -96,7 +97,8 @@ graph_t CS::solve(const graph_t& csg, const SolveParams& params, const bool verb
         return csg_out;
     }
         
-    double_matrix_t A = double_matrix_t::Zero(nmeas, nblob);
+    // The blob-measure incidence, most blobs touch only a few measures.
+    std::vector<Eigen::Triplet<double>> incidence;
 
     for (auto [ei, ei_end] = boost::edges(csg); ei != ei_end; ++ei) {
         const vdesc_t tail = boost::source(*ei, csg);
@@ -117,7 +119,7 @@ graph_t CS::solve(const graph_t& csg, const SolveParams& params, const bool verb
             // someone has violated my requirements with this edge!
             continue;
         }
-        A(mind, bind) = 1;
+        incidence.emplace_back(mind, bind, 1);
 
         boost::add_edge(blob_descs_out.collection[bind],
                         meas_descs_out.collection[mind],
@@ -125,8 +127,11 @@ graph_t CS::solve(const graph_t& csg, const SolveParams& params, const bool verb
     }
 
     
+    Ress::sparse_matrix_t A(nmeas, nblob);
+    A.setFromTriplets(incidence.begin(), incidence.end(), [](double a, double b) { return b; });
+
     double_vector_t m_vec = measure;
-    double_matrix_t R_mat = A;
+    Ress::sparse_matrix_t R_mat = A;
 
     if (params.config != SolveParams::uboone && params.config != SolveParams::simple) {
         THROW(ValueError() << errmsg{String::format("SolveParams config %s not defined", params.config)});
@@ -149,22 +154,22 @@ graph_t CS::solve(const graph_t& csg, const SolveParams& params, const bool verb
 
     if (params.whiten) {
 
-        // std::cerr << "A:\n" << A << "\nmcov:\n" << mcov << "\nmcovinv:\n" << mcov.inverse() << std::endl;
-        Eigen::LLT<double_matrix_t> llt(mcov.inverse());
-        double_matrix_t U = llt.matrixL().transpose();
+        // With a diagonal covariance, the Cholesky factor of its
+        // inverse is diagonal.
+        const double_vector_t U = mvar.cwiseInverse().cwiseSqrt();
         // std::cerr << "U:\n" << U << std::endl;
  
         // The measure vector in a "whitened" basis
-        m_vec = U*measure;
+        m_vec = U.cwiseProduct(measure);
 
         // The blob-measure association in "whitened" basis (becomes
         // the "reasponse" matrix in ress solving).
-        R_mat = params.scale*U*A;
+        R_mat = (params.scale*U).asDiagonal()*A;
     }
     if (verbose) {
         SPDLOG_INFO("CS params {} {}", params.scale, params.whiten);
         SPDLOG_INFO("ress param {} {}", rparams.lambda, rparams.tolerance);
-        SPDLOG_INFO("R_mat \n{}", String::stringify(R_mat));
+        SPDLOG_INFO("R_mat \n{}", String::stringify(double_matrix_t(R_mat)));
         SPDLOG_INFO("m_vec \n{}", String::stringify(m_vec));
         SPDLOG_INFO("source \n{}", String::stringify(source));
         SPDLOG_INFO("weight \n{}", String::stringify(weight));
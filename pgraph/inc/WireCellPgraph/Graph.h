@@ -24,6 +24,7 @@
 
 #include "WireCellPgraph/Node.h"
 #include "WireCellUtil/Logging.h"
+#include "WireCellUtil/NodeProfile.h"
 
 #include <vector>
 #include <unordered_set>
@@ -47,10 +48,33 @@ namespace WireCell {
             // return a topological sort of the graph as per Kahn algorithm.
             std::vector<Node*> sort_kahn();
 
-            // Excute the graph until nodes stop delivering
+            // Execute the graph until nodes stop delivering.  This
+            // uses the "sweep" scheduler which, after each successful
+            // node call, restarts probing from the sink end of the
+            // sorted node list.
             bool execute();
 
-            // Excute parents of node or if any parent is not ready,
+            // Execute the graph until nodes stop delivering using the
+            // "ready" scheduler.  A node is only probed again after
+            // one of its input edges gains data or one of its output
+            // edges drains.  The most downstream ready node is always
+            // called first so the call order is the same as from
+            // execute() but without the repeated failed probes.
+            bool execute_ready();
+
+            // Execute the graph using a pool of nthreads worker
+            // threads, zero meaning one per hardware thread.  Nodes
+            // supporting the split call protocol (see Node) run
+            // concurrently with each other and with themselves up to
+            // their concurrency().  Output of a node is put to its
+            // edges in the order its input was taken.  Others are
+            // called one at a time.  A worker prefers to call again
+            // the node it last called.  Any exception from a node is
+            // rethrown after all workers stop.  Timers accumulate
+            // wall-clock instead of CPU time.
+            bool execute_threaded(size_t nthreads = 0);
+
+            // Execute parents of node or if any parent is not ready,
             // recursively call this method on parent.  Return number
             // of nodes executed.
             int execute_upstream(Node* node);
@@ -64,13 +88,40 @@ namespace WireCell {
             // Print out cumulated CPU time for executing each node
             void print_timers() const;
 
+            // Total number of node calls made so far, failed or not.
+            size_t nprobes() const { return m_nprobes; }
+
+            // Number of node calls that returned true.
+            size_t ncalls() const { return m_ncalls; }
+
+            // Record each successful node call of any execution to
+            // the profile.  A nullptr turns off profiling.
+            void set_profile(NodeProfile* profile) { m_profile = profile; }
+
            private:
+            // Call node, accumulating its CPU time and probe counts.
+            bool timed_call(Node* node);
+
+            // For each sorted node, the queues of all its edges paired
+            // with the index of the node at the other end.
+            typedef std::vector<std::vector<std::pair<Queue*, size_t> > > links_t;
+            links_t make_links(const std::vector<Node*>& nodes);
+
+            // Add one call to the profile, if any.
+            void profile_call(Node* node, NodeProfile::time_point_t start, NodeProfile::time_point_t stop,
+                              size_t queued, size_t nin, size_t nout);
+
             std::vector<std::pair<Node*, Node*> > m_edges;
+            // Map the queue of each edge to its tail and head nodes.
+            std::unordered_map<Queue*, std::pair<Node*, Node*> > m_edge_ends;
             std::unordered_set<Node*> m_nodes;
             std::unordered_map<Node*, std::vector<Node*> > m_edges_forward, m_edges_backward;
             Log::logptr_t l;
             Log::logptr_t l_timer;
             std::unordered_map<Node*, float> m_nodes_timer;
+            size_t m_nprobes{0}, m_ncalls{0};
+            NodeProfile* m_profile{nullptr};
+            std::unordered_map<Node*, size_t> m_profile_index;
         };
     }  // namespace Pgraph
 }  // namespace WireCell
@@ -3,6 +3,8 @@
 
 #include "WireCellPgraph/Port.h"
 
+#include <algorithm>
+
 namespace WireCell {
     namespace Pgraph {
 
@@ -19,6 +21,36 @@ namespace WireCell {
             // Concrete node must return some instance identifier.
             virtual std::string ident() = 0;
 
+            // Number of calls of this node which may run at the
+            // same time in a threaded execution.  Zero means no limit.
+            virtual int concurrency() { return 1; }
+
+            // A node may support threaded execution by splitting its
+            // operator() into take() and compute().  Nodes which do
+            // not are called via operator() while the graph is locked.
+            virtual bool splittable() { return false; }
+
+            // Pop the input for one call from the input ports.
+            // Return false, leaving ports untouched, if not ready.
+            virtual bool take(PortQueues& inputs) { return false; }
+
+            // Process input taken by take(), filling outputs for
+            // give().  This must not touch any port.  Return false
+            // if the call did not produce anything.
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs) { return false; }
+
+            // Put output from compute() to the output ports.
+            void give(PortQueues& outputs)
+            {
+                auto& oports = output_ports();
+                const size_t nout = std::min(outputs.size(), oports.size());
+                for (size_t ind = 0; ind < nout; ++ind) {
+                    for (auto& obj : outputs[ind]) {
+                        oports[ind].put(obj);
+                    }
+                }
+            }
+
             Port& iport(size_t ind = 0) { return port(Port::input, ind); }
             Port& oport(size_t ind = 0) { return port(Port::output, ind); }
 
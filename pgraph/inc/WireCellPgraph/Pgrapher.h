@@ -46,6 +46,21 @@
     As when configuraing a component itself, the name need only be
     specified in an edge pair if not using the default (empty string).
 
+    The optional "scheduler" parameter selects how the graph decides
+    which node to call next.  The default "sweep" re-probes every
+    node from the sink end after each successful call.  The "ready"
+    scheduler gives the same call order but only probes a node after
+    one of its edges has changed, which is cheaper for large graphs.
+    The "threaded" scheduler runs nodes concurrently on a pool of
+    "nthreads" threads (default 0 means one per hardware thread)
+    honoring each node's concurrency() and preserving the order of
+    data on each edge.
+
+    If the "profile" parameter names a file, each node call is
+    recorded and written as Chrome / Perfetto trace event JSON to
+    that file when the Pgrapher is finalized.  If "profile_memory" is
+    true the resident memory is also sampled after each call.
+
  */
 
 #ifndef WIRECELL_PGRAPH_PGRAPHER
@@ -53,14 +68,19 @@
 
 #include "WireCellIface/IApplication.h"
 #include "WireCellIface/IConfigurable.h"
+#include "WireCellIface/ITerminal.h"
 #include "WireCellAux/Logger.h"
+#include "WireCellUtil/NodeProfile.h"
 #include "WireCellPgraph/Graph.h"
 
+#include <memory>
+
 namespace WireCell::Pgraph {
 
     class Pgrapher : public Aux::Logger,
                      public IApplication,
-                     public IConfigurable
+                     public IConfigurable,
+                     public ITerminal
     {
       public:
         Pgrapher();
@@ -73,8 +93,15 @@ namespace WireCell::Pgraph {
         virtual void configure(const WireCell::Configuration& config);
         virtual WireCell::Configuration default_configuration() const;
 
+        // ITerminal
+        virtual void finalize();
+
       private:
         Graph m_graph;
+        std::string m_scheduler{"sweep"};
+        size_t m_nthreads{0};
+        std::string m_profile_file{""};
+        std::unique_ptr<NodeProfile> m_profile;
 
     };
 
@@ -24,6 +24,10 @@ namespace WireCell {
         // Edges are just queues that can be shared.
         typedef std::shared_ptr<Queue> Edge;
 
+        // Data taken from or given to each of a node's ports of one
+        // type, indexed by port number.
+        typedef std::vector<Queue> PortQueues;
+
         class Node;
 
         class Port {
@@ -34,7 +34,8 @@ namespace WireCell {
         // node returns false meaning no change of data.
 
         // Base class taking care of constructing ports and providing
-        // ident().
+        // ident().  Subclasses implement the split call protocol of
+        // take() and compute() from which operator() is made.
         class PortedNode : public Pgraph::Node {
            public:
             PortedNode(INode::pointer wcnode)
@@ -72,6 +73,21 @@ namespace WireCell {
                 return ss.str();
             }
 
+            virtual int concurrency() { return m_wcnode->concurrency(); }
+
+            virtual bool splittable() { return true; }
+
+            virtual bool operator()()
+            {
+                PortQueues inputs, outputs;
+                if (!take(inputs)) {
+                    return false;
+                }
+                bool ok = compute(inputs, outputs);
+                give(outputs);
+                return ok;
+            }
+
            private:
             INode::pointer m_wcnode;
         };
@@ -89,19 +105,23 @@ namespace WireCell {
             }
             virtual ~Source() {}
 
-            virtual bool operator()()
+            virtual bool take(PortQueues& inputs)
             {
-                Port& op = oport();
-                if (op.size()) {
+                if (oport().size()) {
                     return false;  // don't call me if I've got existing output waiting
                 }
+                return true;
+            }
 
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+            {
                 boost::any obj;
                 m_ok = (*m_wcnode)(obj);
                 if (!m_ok) {
                     return false;
                 }
-                oport().put(obj);
+                outputs.resize(1);
+                outputs[0].push_back(obj);
                 return true;
             }
         };
@@ -116,14 +136,21 @@ namespace WireCell {
                 m_wcnode = std::dynamic_pointer_cast<ISinkNodeBase>(wcnode);
             }
             virtual ~Sink() {}
-            virtual bool operator()()
+
+            virtual bool take(PortQueues& inputs)
             {
                 Port& ip = iport();
                 if (ip.empty()) {
                     return false;  // don't call me if there is nothing to give me.
                 }
-                auto obj = ip.get();
-                bool ok = (*m_wcnode)(obj);
+                inputs.resize(1);
+                inputs[0].push_back(ip.get());
+                return true;
+            }
+
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+            {
+                bool ok = (*m_wcnode)(inputs[0].front());
                 // std::cerr << "Sink returns: " << ok << std::endl;
                 return ok;
             }
@@ -139,23 +166,30 @@ namespace WireCell {
                 m_wcnode = std::dynamic_pointer_cast<IFunctionNodeBase>(wcnode);
             }
             virtual ~Function() {}
-            virtual bool operator()()
+
+            virtual bool take(PortQueues& inputs)
             {
-                Port& op = oport();
-                if (op.size()) {
+                if (oport().size()) {
                     return false;  // don't call me if I've got existing output waiting
                 }
                 Port& ip = iport();
                 if (ip.empty()) {
                     return false;  // don't call me if there is nothing to give me.
                 }
+                inputs.resize(1);
+                inputs[0].push_back(ip.get());
+                return true;
+            }
+
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+            {
                 boost::any out;
-                auto in = ip.get();
-                bool ok = (*m_wcnode)(in, out);
+                bool ok = (*m_wcnode)(inputs[0].front(), out);
                 if (!ok) {
                     return false;
                 }
-                op.put(out);
+                outputs.resize(1);
+                outputs[0].push_back(out);
                 return true;
             }
         };
@@ -170,19 +204,25 @@ namespace WireCell {
                 m_wcnode = std::dynamic_pointer_cast<IQueuedoutNodeBase>(wcnode);
             }
             virtual ~Queuedout() {}
-            virtual bool operator()()
+
+            virtual bool take(PortQueues& inputs)
             {
                 Port& ip = iport();
                 if (ip.empty()) {
                     return false;
                 }
+                inputs.resize(1);
+                inputs[0].push_back(ip.get());
+                return true;
+            }
+
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+            {
                 IQueuedoutNodeBase::queuedany outv;
-                auto in = ip.get();
-                bool ok = (*m_wcnode)(in, outv);
+                bool ok = (*m_wcnode)(inputs[0].front(), outv);
                 if (!ok) return false;
-                for (auto out : outv) {
-                    oport().put(out);
-                }
+                outputs.resize(1);
+                outputs[0].insert(outputs[0].end(), outv.begin(), outv.end());
                 return true;
             }
         };
@@ -200,7 +240,8 @@ namespace WireCell {
                 m_wcnode = std::dynamic_pointer_cast<INodeBaseType>(wcnode);
             }
             virtual ~JoinFanin() {}
-            virtual bool operator()()
+
+            virtual bool take(PortQueues& inputs)
             {
                 Port& op = oport();
                 if (!op.empty()) {
@@ -214,16 +255,27 @@ namespace WireCell {
                         return false;
                     }
                 }
+                inputs.resize(nin);
+                for (size_t ind = 0; ind < nin; ++ind) {
+                    inputs[ind].push_back(iports[ind].get());
+                }
+                return true;
+            }
+
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+            {
+                const size_t nin = inputs.size();
                 any_vector inv(nin);
                 for (size_t ind = 0; ind < nin; ++ind) {
-                    inv[ind] = iports[ind].get();
+                    inv[ind] = inputs[ind].front();
                 }
                 boost::any out;
                 bool ok = (*m_wcnode)(inv, out);
                 if (!ok) {
                     return false;
                 }
-                op.put(out);
+                outputs.resize(1);
+                outputs[0].push_back(out);
                 return true;
             }
 
@@ -246,7 +298,8 @@ namespace WireCell {
                 m_wcnode = std::dynamic_pointer_cast<inode_type>(wcnode);
             }
             virtual ~SplitFanout() {}
-            virtual bool operator()()
+
+            virtual bool take(PortQueues& inputs)
             {
                 Port& ip = iport();
                 if (ip.empty()) {
@@ -266,16 +319,23 @@ namespace WireCell {
                     return false;  // don't call me if all my output has something
                 }
 
-                auto in = ip.get();
+                inputs.resize(1);
+                inputs[0].push_back(ip.get());
+                return true;
+            }
 
+            virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+            {
+                const size_t nout = output_ports().size();
                 any_vector outv(nout);
-                bool ok = (*m_wcnode)(in, outv);
+                bool ok = (*m_wcnode)(inputs[0].front(), outv);
                 if (!ok) {
                     return false;
                 }
                 // std::cerr << "SplitFanout: " << nout << " " << outv.size() << std::endl;
+                outputs.resize(nout);
                 for (size_t ind = 0; ind < nout; ++ind) {
-                    oports[ind].put(outv[ind]);
+                    outputs[ind].push_back(outv[ind]);
                 }
                 return true;
             }
@@ -309,6 +369,9 @@ namespace WireCell {
             }
             virtual ~Hydra() {}
 
+            // Hydra peeks at whole input queues so can not be split.
+            virtual bool splittable() { return false; }
+
             virtual bool operator()()
             {
                 auto& iports = input_ports();
@@ -3,12 +3,52 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <set>
+#include <map>
 #include <ctime>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <boost/algorithm/string.hpp>
 
 using WireCell::demangle;
+using WireCell::NodeProfile;
 using namespace WireCell::Pgraph;
 
+// Number of objects queued on the edges of the ports.
+static size_t queue_depth(PortList& ports)
+{
+    size_t num = 0;
+    for (auto& port : ports) {
+        num += port.size();
+    }
+    return num;
+}
+
+// Number of objects held by the queues.
+static size_t queue_depth(const PortQueues& queues)
+{
+    size_t num = 0;
+    for (const auto& q : queues) {
+        num += q.size();
+    }
+    return num;
+}
+
+// A short name for the node, the WCT type for wrapped nodes.
+static std::string short_name(Node* node)
+{
+    std::string iden = node->ident();
+    std::vector<std::string> tags;
+    boost::split(tags, iden, [](char c) { return c == ' '; });
+    if (tags.size() > 2 and tags[0] == "<Node" and tags[2].size() > 5) {
+        return tags[2].substr(5);
+    }
+    return iden;
+}
+
 Graph::Graph()
   : l(Log::logger("pgraph"))
   , l_timer(Log::logger("timer"))
@@ -29,6 +69,7 @@ bool Graph::connect(Node* tail, Node* head, size_t tpind, size_t hpind)
 
     m_edges.push_back(std::make_pair(tail, head));
     Edge edge = std::make_shared<Queue>();
+    m_edge_ends[edge.get()] = std::make_pair(tail, head);
 
     tport.plug(edge);
     hport.plug(edge);
@@ -102,9 +143,6 @@ bool Graph::execute()
     auto nodes = sort_kahn();
     l->debug("executing with {} nodes", nodes.size());
 
-    std::clock_t start;
-    double duration = 0;
-
     while (true) {
         int count = 0;
         bool did_something = false;
@@ -112,17 +150,7 @@ bool Graph::execute()
         for (auto nit = nodes.rbegin(); nit != nodes.rend(); ++nit, ++count) {
             Node* node = *nit;
 
-            start = std::clock();
-
-            bool ok = call_node(node);
-
-            duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
-            if (m_nodes_timer.find(node) != m_nodes_timer.end()) {
-                m_nodes_timer[node] += duration;
-            }
-            else {
-                m_nodes_timer[node] = duration;
-            }
+            bool ok = timed_call(node);
 
             if (ok) {
                 SPDLOG_LOGGER_TRACE(l, "ran node {}: {}", count, node->ident());
@@ -138,6 +166,348 @@ bool Graph::execute()
     return true;  // shouldn't reach
 }
 
+bool Graph::execute_ready()
+{
+    auto nodes = sort_kahn();
+    const size_t nnodes = nodes.size();
+    l->debug("executing with {} nodes using ready scheduler", nnodes);
+
+    auto links = make_links(nodes);
+
+    // Indices of nodes which may deliver if called.  Highest index
+    // is most downstream and is called first.
+    std::set<size_t> ready;
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        ready.insert(ind);
+    }
+
+    std::vector<size_t> before;
+    while (!ready.empty()) {
+        auto rit = std::prev(ready.end());
+        const size_t ind = *rit;
+        ready.erase(rit);
+
+        Node* node = nodes[ind];
+        const auto& mylinks = links[ind];
+
+        before.resize(mylinks.size());
+        for (size_t lind = 0; lind < mylinks.size(); ++lind) {
+            before[lind] = mylinks[lind].first->size();
+        }
+
+        bool ok = timed_call(node);
+
+        // Any change to an edge may make the node at its other end
+        // ready.  A node which delivered may have more to give.
+        bool changed = false;
+        for (size_t lind = 0; lind < mylinks.size(); ++lind) {
+            if (mylinks[lind].first->size() != before[lind]) {
+                ready.insert(mylinks[lind].second);
+                changed = true;
+            }
+        }
+        if (ok or changed) {
+            SPDLOG_LOGGER_TRACE(l, "ran node {}: {}", ind, node->ident());
+            ready.insert(ind);
+        }
+    }
+    return true;
+}
+
+namespace {
+    // Bookkeeping of one node in a threaded execution.
+    struct ThreadedNode {
+        // Maximum and current number of calls in progress.
+        size_t limit{1}, nrunning{0};
+        // Sequence number to give to the next take() and of the
+        // next output to give().
+        size_t next_take{0}, next_give{0};
+        // True if the node was passed over for being at its limit.
+        bool blocked{false};
+        // Finished output waiting for its turn to be given.
+        std::map<size_t, WireCell::Pgraph::PortQueues> done;
+    };
+}  // namespace
+
+bool Graph::execute_threaded(size_t nthreads)
+{
+    if (!nthreads) {
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto nodes = sort_kahn();
+    const size_t nnodes = nodes.size();
+    l->debug("executing with {} nodes using {} threads", nnodes, nthreads);
+
+    auto links = make_links(nodes);
+
+    std::vector<ThreadedNode> tnodes(nnodes);
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        size_t limit = 1;
+        if (nodes[ind]->splittable()) {
+            const int conc = nodes[ind]->concurrency();
+            limit = conc <= 0 ? nthreads : std::min((size_t) conc, nthreads);
+        }
+        tnodes[ind].limit = limit;
+    }
+
+    std::set<size_t> ready;
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        ready.insert(ind);
+    }
+
+    // All below is guarded by the mutex.
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t nrunning = 0;
+    std::exception_ptr error;
+
+    auto snapshot = [&](size_t ind, std::vector<size_t>& before) {
+        const auto& mylinks = links[ind];
+        before.resize(mylinks.size());
+        for (size_t lind = 0; lind < mylinks.size(); ++lind) {
+            before[lind] = mylinks[lind].first->size();
+        }
+    };
+    // Make ready the nodes at the other end of changed edges.
+    auto wake = [&](size_t ind, const std::vector<size_t>& before) {
+        const auto& mylinks = links[ind];
+        bool changed = false;
+        for (size_t lind = 0; lind < mylinks.size(); ++lind) {
+            if (mylinks[lind].first->size() != before[lind]) {
+                ready.insert(mylinks[lind].second);
+                changed = true;
+            }
+        }
+        return changed;
+    };
+    auto add_time = [&](Node* node, std::chrono::steady_clock::time_point start) {
+        std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+        m_nodes_timer[node] += dt.count();
+    };
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::vector<size_t> before;
+        size_t last = nnodes;  // the node this worker last called
+
+        while (!error) {
+            // Find a node to call, preferring the last one, then the
+            // most downstream.
+            std::vector<size_t> cands(ready.rbegin(), ready.rend());
+            if (last < nnodes and ready.count(last)) {
+                cands.insert(cands.begin(), last);
+            }
+
+            size_t ind = nnodes;
+            size_t seqno = 0, queued = 0;
+            PortQueues inputs;
+            bool called = false;
+            try {
+                for (size_t cand : cands) {
+                    auto& tn = tnodes[cand];
+                    Node* node = nodes[cand];
+                    if (tn.nrunning >= tn.limit) {
+                        tn.blocked = true;
+                        ready.erase(cand);
+                        continue;
+                    }
+
+                    snapshot(cand, before);
+
+                    if (!node->splittable()) {
+                        // Call directly while holding the lock.
+                        const size_t nqin = queue_depth(node->input_ports());
+                        const size_t nqout = queue_depth(node->output_ports());
+                        auto start = std::chrono::steady_clock::now();
+                        bool ok = call_node(node);
+                        add_time(node, start);
+                        ++m_nprobes;
+                        if (ok) {
+                            ++m_ncalls;
+                            const size_t nin = nqin - queue_depth(node->input_ports());
+                            const size_t nout = queue_depth(node->output_ports()) - nqout;
+                            profile_call(node, start, std::chrono::steady_clock::now(), nqin, nin, nout);
+                        }
+                        if (wake(cand, before) or ok) {
+                            called = true;
+                            last = cand;
+                            break;
+                        }
+                        ready.erase(cand);
+                        continue;
+                    }
+
+                    ++m_nprobes;
+                    queued = queue_depth(node->input_ports());
+                    if (!node->take(inputs)) {
+                        ready.erase(cand);
+                        continue;
+                    }
+                    wake(cand, before);
+                    seqno = tn.next_take++;
+                    ++tn.nrunning;
+                    ++nrunning;
+                    if (tn.nrunning >= tn.limit) {
+                        ready.erase(cand);
+                    }
+                    ind = cand;
+                    break;
+                }
+            }
+            catch (...) {
+                error = std::current_exception();
+                break;
+            }
+
+            if (called) {
+                cv.notify_all();
+                continue;
+            }
+
+            if (ind == nnodes) {
+                if (nrunning == 0) {
+                    break;  // nothing running can make anything ready
+                }
+                cv.wait(lock);
+                continue;
+            }
+
+            // Others may find more to start.
+            cv.notify_all();
+
+            Node* node = nodes[ind];
+            last = ind;
+            PortQueues outputs;
+            bool ok = false;
+
+            lock.unlock();
+            auto start = std::chrono::steady_clock::now();
+            try {
+                ok = node->compute(inputs, outputs);
+            }
+            catch (...) {
+                lock.lock();
+                error = std::current_exception();
+                break;
+            }
+            auto stop = std::chrono::steady_clock::now();
+            lock.lock();
+
+            add_time(node, start);
+            if (ok) {
+                ++m_ncalls;
+                profile_call(node, start, stop, queued, queue_depth(inputs), queue_depth(outputs));
+                SPDLOG_LOGGER_TRACE(l, "ran node {}: {}", ind, node->ident());
+            }
+
+            // Give output in the order that input was taken.
+            auto& tn = tnodes[ind];
+            tn.done[seqno] = std::move(outputs);
+            snapshot(ind, before);
+            try {
+                while (!tn.done.empty() and tn.done.begin()->first == tn.next_give) {
+                    node->give(tn.done.begin()->second);
+                    tn.done.erase(tn.done.begin());
+                    ++tn.next_give;
+                }
+            }
+            catch (...) {
+                error = std::current_exception();
+                break;
+            }
+            bool changed = wake(ind, before);
+            --tn.nrunning;
+            --nrunning;
+            // A call which returns false may leave input which no
+            // upstream node will come to wake us for.
+            if (ok or changed or tn.blocked or queue_depth(node->input_ports()) > 0) {
+                tn.blocked = false;
+                ready.insert(ind);
+            }
+            cv.notify_all();
+        }
+        cv.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t ind = 0; ind < nthreads; ++ind) {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return true;
+}
+
+Graph::links_t Graph::make_links(const std::vector<Node*>& nodes)
+{
+    const size_t nnodes = nodes.size();
+    std::unordered_map<Node*, size_t> index;
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        index[nodes[ind]] = ind;
+    }
+
+    links_t links(nnodes);
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        Node* node = nodes[ind];
+        for (auto& port : node->input_ports()) {
+            Queue* q = port.edge().get();
+            links[ind].emplace_back(q, index[m_edge_ends[q].first]);
+        }
+        for (auto& port : node->output_ports()) {
+            Queue* q = port.edge().get();
+            links[ind].emplace_back(q, index[m_edge_ends[q].second]);
+        }
+    }
+    return links;
+}
+
+bool Graph::timed_call(Node* node)
+{
+    size_t nqin = 0, nqout = 0;
+    NodeProfile::time_point_t wstart;
+    if (m_profile) {
+        nqin = queue_depth(node->input_ports());
+        nqout = queue_depth(node->output_ports());
+        wstart = NodeProfile::clock_t::now();
+    }
+
+    std::clock_t start = std::clock();
+
+    bool ok = call_node(node);
+
+    double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+    m_nodes_timer[node] += duration;
+
+    ++m_nprobes;
+    if (ok) {
+        ++m_ncalls;
+        if (m_profile) {
+            const size_t nin = nqin - queue_depth(node->input_ports());
+            const size_t nout = queue_depth(node->output_ports()) - nqout;
+            profile_call(node, wstart, NodeProfile::clock_t::now(), nqin, nin, nout);
+        }
+    }
+    return ok;
+}
+
+void Graph::profile_call(Node* node, NodeProfile::time_point_t start, NodeProfile::time_point_t stop,
+                         size_t queued, size_t nin, size_t nout)
+{
+    if (!m_profile) {
+        return;
+    }
+    auto it = m_profile_index.find(node);
+    if (it == m_profile_index.end()) {
+        it = m_profile_index.emplace(node, m_profile->add_node(short_name(node))).first;
+    }
+    m_profile->record(it->second, start, stop, queued, nin, nout);
+}
+
 bool Graph::call_node(Node* node)
 {
     if (!node) {
@@ -176,12 +546,10 @@ void Graph::print_timers() const
         m.emplace(it.second, it.first);
     }
     for (auto it = m.rbegin(); it != m.rend(); ++it) {
-        std::string iden = it->second->ident();
-        std::vector<std::string> tags;
-        boost::split(tags, iden, [](char c) { return c == ' '; });
-        l_timer->info("Timer: {} : {} sec", tags[2].substr(5), it->first);
+        l_timer->info("Timer: {} : {} sec", short_name(it->second), it->first);
         total_time += it->first;
     }
 
     l_timer->info("Timer: Total node execution : {} sec", total_time);
+    l_timer->info("Timer: {} node probes for {} node calls", m_nprobes, m_ncalls);
 }
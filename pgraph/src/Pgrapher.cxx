@@ -3,7 +3,8 @@
 #include "WireCellIface/INode.h"
 #include "WireCellUtil/NamedFactory.h"
 
-WIRECELL_FACTORY(Pgrapher, WireCell::Pgraph::Pgrapher, WireCell::IApplication, WireCell::IConfigurable)
+WIRECELL_FACTORY(Pgrapher, WireCell::Pgraph::Pgrapher,
+                 WireCell::IApplication, WireCell::IConfigurable, WireCell::ITerminal)
 
 using WireCell::get;
 using namespace WireCell::Pgraph;
@@ -13,6 +14,18 @@ WireCell::Configuration Pgrapher::default_configuration() const
     Configuration cfg;
 
     cfg["edges"] = Json::arrayValue;
+    // How to decide which node to call next.  "sweep" probes the
+    // sorted nodes from sink to source after every call.  "ready"
+    // only probes nodes that had an edge change since last probed.
+    // "threaded" runs nodes concurrently on "nthreads" threads.
+    cfg["scheduler"] = m_scheduler;
+    // Number of threads for the "threaded" scheduler, zero for one
+    // per hardware thread.
+    cfg["nthreads"] = (int)m_nthreads;
+    // If set, name a file to receive a trace of all node calls.
+    cfg["profile"] = m_profile_file;
+    // If true, also sample resident memory after each node call.
+    cfg["profile_memory"] = false;
     return cfg;
 }
 
@@ -49,6 +62,13 @@ std::string edge_to_string(WireCell::Configuration tail,
 void Pgrapher::configure(const WireCell::Configuration& cfg)
 
 {
+    m_scheduler = get<std::string>(cfg, "scheduler", m_scheduler);
+    m_nthreads = get<int>(cfg, "nthreads", m_nthreads);
+    if (m_scheduler != "sweep" and m_scheduler != "ready" and m_scheduler != "threaded") {
+        log->critical("unknown scheduler: \"{}\"", m_scheduler);
+        raise<ValueError>("unknown scheduler: \"%s\"", m_scheduler);
+    }
+
     Pgraph::Factory fac;
     log->debug("connecting: {} edges", cfg["edges"].size());
     for (auto jedge : cfg["edges"]) {
@@ -67,16 +87,42 @@ void Pgrapher::configure(const WireCell::Configuration& cfg)
         log->critical("graph not fully connected");
         raise<ValueError>("graph not fully connected");
     }
+
+    m_profile_file = get<std::string>(cfg, "profile", m_profile_file);
+    if (m_profile_file.empty()) {
+        m_profile.reset();
+    }
+    else {
+        m_profile = std::make_unique<NodeProfile>(get<bool>(cfg, "profile_memory", false));
+    }
+    m_graph.set_profile(m_profile.get());
 }
 
 void Pgrapher::execute()
 {
-    log->debug("executing graph");
-    m_graph.execute();
+    log->debug("executing graph with \"{}\" scheduler", m_scheduler);
+    if (m_scheduler == "ready") {
+        m_graph.execute_ready();
+    }
+    else if (m_scheduler == "threaded") {
+        m_graph.execute_threaded(m_nthreads);
+    }
+    else {
+        m_graph.execute();
+    }
     log->debug("graph execution complete");
     m_graph.print_timers();
 }
 
+void Pgrapher::finalize()
+{
+    if (!m_profile) {
+        return;
+    }
+    log->debug("writing profile of {} node calls to {}", m_profile->calls().size(), m_profile_file);
+    m_profile->dump(m_profile_file);
+}
+
 Pgrapher::Pgrapher()
     : Aux::Logger("Pgrapher", "pgraph")
 {
@@ -0,0 +1,222 @@
+/** Benchmark the Pgraph "sweep" and "ready" schedulers.
+
+    A graph resembling a multi-APA sim+sigproc job is built: a number
+    of parallel branches each with a source feeding a chain of
+    functions all joined into a single fan-in and sink.  Each
+    scheduler executes an identical copy of the graph and the number
+    of node probes per object delivered to the sink is reported.
+
+    Usage: check_pgraph_scheduler [nbranches [nfuncs [nobjects]]]
+ */
+
+#include "WireCellPgraph/Graph.h"
+#include "WireCellUtil/Testing.h"
+
+#include <boost/any.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace WireCell;
+
+// Sequence of node idents in order of successful calls.
+using call_log_t = std::vector<std::string>;
+
+class BNode : public Pgraph::Node {
+   public:
+    BNode(call_log_t& calls, const std::string& name, size_t nin, size_t nout)
+      : m_calls(calls)
+      , m_name(name)
+    {
+        using Pgraph::Port;
+        for (size_t ind = 0; ind < nin; ++ind) {
+            m_ports[Port::input].push_back(Port(this, Port::input, "int"));
+        }
+        for (size_t ind = 0; ind < nout; ++ind) {
+            m_ports[Port::output].push_back(Port(this, Port::output, "int"));
+        }
+    }
+    virtual ~BNode() {}
+    virtual std::string ident() { return m_name; }
+
+   protected:
+    bool called()
+    {
+        m_calls.push_back(m_name);
+        return true;
+    }
+
+   private:
+    call_log_t& m_calls;
+    std::string m_name;
+};
+
+// Like Pgraph::Source wrapper, only produce when output is drained.
+class BSource : public BNode {
+    int m_num, m_end;
+
+   public:
+    BSource(call_log_t& calls, const std::string& name, int nobjects)
+      : BNode(calls, name, 0, 1)
+      , m_num(0)
+      , m_end(nobjects)
+    {
+    }
+    virtual bool operator()()
+    {
+        if (oport().size() or m_num >= m_end) {
+            return false;
+        }
+        Pgraph::Data d = m_num++;
+        oport().put(d);
+        return called();
+    }
+};
+
+// Like Pgraph::Function wrapper.
+class BFunction : public BNode {
+   public:
+    BFunction(call_log_t& calls, const std::string& name)
+      : BNode(calls, name, 1, 1)
+    {
+    }
+    virtual bool operator()()
+    {
+        if (oport().size() or iport().empty()) {
+            return false;
+        }
+        Pgraph::Data d = boost::any_cast<int>(iport().get()) + 1;
+        oport().put(d);
+        return called();
+    }
+};
+
+// Like Pgraph::Fanin wrapper.
+class BFanin : public BNode {
+   public:
+    BFanin(call_log_t& calls, const std::string& name, size_t nin)
+      : BNode(calls, name, nin, 1)
+    {
+    }
+    virtual bool operator()()
+    {
+        if (oport().size()) {
+            return false;
+        }
+        for (auto& ip : input_ports()) {
+            if (ip.empty()) {
+                return false;
+            }
+        }
+        int sum = 0;
+        for (auto& ip : input_ports()) {
+            sum += boost::any_cast<int>(ip.get());
+        }
+        Pgraph::Data d = sum;
+        oport().put(d);
+        return called();
+    }
+};
+
+class BSink : public BNode {
+   public:
+    BSink(call_log_t& calls, const std::string& name)
+      : BNode(calls, name, 1, 0)
+    {
+    }
+    size_t ndelivered{0};
+    virtual bool operator()()
+    {
+        if (iport().empty()) {
+            return false;
+        }
+        iport().get();
+        ++ndelivered;
+        return called();
+    }
+};
+
+struct Bench {
+    call_log_t calls;
+    std::vector<std::unique_ptr<Pgraph::Node> > nodes;
+    BSink* sink{nullptr};
+    Pgraph::Graph graph;
+
+    Bench(size_t nbranches, size_t nfuncs, int nobjects)
+    {
+        auto fanin = new BFanin(calls, "fanin", nbranches);
+        nodes.emplace_back(fanin);
+        sink = new BSink(calls, "sink");
+        nodes.emplace_back(sink);
+        graph.connect(fanin, sink);
+
+        for (size_t bind = 0; bind < nbranches; ++bind) {
+            std::stringstream ss;
+            ss << "src" << bind;
+            Pgraph::Node* last = new BSource(calls, ss.str(), nobjects);
+            nodes.emplace_back(last);
+            for (size_t find = 0; find < nfuncs; ++find) {
+                std::stringstream fs;
+                fs << "fun" << bind << "_" << find;
+                auto fun = new BFunction(calls, fs.str());
+                nodes.emplace_back(fun);
+                graph.connect(last, fun);
+                last = fun;
+            }
+            graph.connect(last, fanin, 0, bind);
+        }
+        Assert(graph.connected());
+    }
+
+    void report(const std::string& name, double seconds)
+    {
+        const size_t nprobes = graph.nprobes();
+        const size_t ndelivered = sink->ndelivered;
+        std::cerr << name << ": " << nodes.size() << " nodes, "
+                  << nprobes << " probes, "
+                  << graph.ncalls() << " calls, "
+                  << ndelivered << " delivered, "
+                  << (double) nprobes / ndelivered << " probes/delivered, "
+                  << seconds << " s\n";
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    size_t nbranches = 6;
+    size_t nfuncs = 9;
+    int nobjects = 100;
+    if (argc > 1) nbranches = atoi(argv[1]);
+    if (argc > 2) nfuncs = atoi(argv[2]);
+    if (argc > 3) nobjects = atoi(argv[3]);
+
+    Bench sweep(nbranches, nfuncs, nobjects);
+    auto t0 = std::chrono::steady_clock::now();
+    sweep.graph.execute();
+    auto t1 = std::chrono::steady_clock::now();
+    sweep.report("sweep", std::chrono::duration<double>(t1 - t0).count());
+
+    Bench ready(nbranches, nfuncs, nobjects);
+    t0 = std::chrono::steady_clock::now();
+    ready.graph.execute_ready();
+    t1 = std::chrono::steady_clock::now();
+    ready.report("ready", std::chrono::duration<double>(t1 - t0).count());
+
+    Assert(sweep.sink->ndelivered == (size_t) nobjects);
+    Assert(ready.sink->ndelivered == (size_t) nobjects);
+    Assert(sweep.graph.ncalls() == ready.graph.ncalls());
+    Assert(ready.graph.nprobes() <= sweep.graph.nprobes());
+    // Both schedulers must call each node the same number of times.
+    // The order is not compared as the Kahn sort of two otherwise
+    // identical graphs depends on node addresses.
+    std::sort(sweep.calls.begin(), sweep.calls.end());
+    std::sort(ready.calls.begin(), ready.calls.end());
+    Assert(sweep.calls == ready.calls);
+
+    return 0;
+}
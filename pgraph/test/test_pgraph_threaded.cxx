@@ -0,0 +1,285 @@
+/** Exercise the threaded Pgraph executor.
+
+    Two branches each with a source, a slow function node allowing
+    concurrent calls and a fast function node are joined and sunk.
+    The sink checks that data arrives in order despite the slow
+    nodes finishing their calls out of order.  A Hydra-like node that
+    does not support the split call protocol is also included.  A
+    second graph has a node which returns false once.
+ */
+
+#include "WireCellPgraph/Graph.h"
+#include "WireCellUtil/Testing.h"
+
+#include <boost/any.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+using Pgraph::Port;
+using Pgraph::PortQueues;
+
+class TNode : public Pgraph::Node {
+   public:
+    TNode(const std::string& name, size_t nin, size_t nout, int conc = 1)
+      : m_name(name)
+      , m_conc(conc)
+    {
+        for (size_t ind = 0; ind < nin; ++ind) {
+            m_ports[Port::input].push_back(Port(this, Port::input, "int"));
+        }
+        for (size_t ind = 0; ind < nout; ++ind) {
+            m_ports[Port::output].push_back(Port(this, Port::output, "int"));
+        }
+    }
+    virtual std::string ident() { return m_name; }
+    virtual int concurrency() { return m_conc; }
+    virtual bool splittable() { return true; }
+    virtual bool operator()()
+    {
+        PortQueues inputs, outputs;
+        if (!take(inputs)) {
+            return false;
+        }
+        bool ok = compute(inputs, outputs);
+        give(outputs);
+        return ok;
+    }
+
+   private:
+    std::string m_name;
+    int m_conc;
+};
+
+class TSource : public TNode {
+    int m_num{0}, m_end;
+
+   public:
+    TSource(const std::string& name, int end)
+      : TNode(name, 0, 1)
+      , m_end(end)
+    {
+    }
+    virtual bool take(PortQueues& inputs) { return oport().empty(); }
+    virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+    {
+        if (m_num >= m_end) {
+            return false;
+        }
+        outputs.resize(1);
+        outputs[0].push_back(m_num++);
+        return true;
+    }
+};
+
+class TFunction : public TNode {
+    int m_sleep_us;
+
+   public:
+    std::atomic<int> nactive{0}, maxactive{0};
+
+    TFunction(const std::string& name, int conc, int sleep_us)
+      : TNode(name, 1, 1, conc)
+      , m_sleep_us(sleep_us)
+    {
+    }
+    virtual bool take(PortQueues& inputs)
+    {
+        if (iport().empty()) {
+            return false;
+        }
+        inputs.resize(1);
+        inputs[0].push_back(iport().get());
+        return true;
+    }
+    virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+    {
+        int now = ++nactive;
+        int prev = maxactive;
+        while (now > prev and !maxactive.compare_exchange_weak(prev, now)) {
+        }
+        int num = boost::any_cast<int>(inputs[0].front());
+        // Early numbers take longest so calls finish out of order.
+        std::this_thread::sleep_for(std::chrono::microseconds(m_sleep_us * (1 + (10 - num % 10))));
+        --nactive;
+        outputs.resize(1);
+        outputs[0].push_back(num);
+        return true;
+    }
+};
+
+// Puts all its objects at once.
+class TBurst : public TNode {
+    int m_end;
+    bool m_done{false};
+
+   public:
+    TBurst(const std::string& name, int end)
+      : TNode(name, 0, 1)
+      , m_end(end)
+    {
+    }
+    virtual bool take(PortQueues& inputs) { return oport().empty(); }
+    virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+    {
+        if (m_done) {
+            return false;
+        }
+        outputs.resize(1);
+        for (int num = 0; num < m_end; ++num) {
+            outputs[0].push_back(num);
+        }
+        m_done = true;
+        return true;
+    }
+};
+
+// Drops its first object, returning false for that call.
+class TDropFirst : public TNode {
+    bool m_dropped{false};
+
+   public:
+    TDropFirst(const std::string& name)
+      : TNode(name, 1, 1)
+    {
+    }
+    virtual bool take(PortQueues& inputs)
+    {
+        if (iport().empty()) {
+            return false;
+        }
+        inputs.resize(1);
+        inputs[0].push_back(iport().get());
+        return true;
+    }
+    virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+    {
+        if (!m_dropped) {
+            m_dropped = true;
+            return false;
+        }
+        outputs.resize(1);
+        outputs[0].push_back(inputs[0].front());
+        return true;
+    }
+};
+
+// Does not support the split protocol so is called under lock.
+class TJoin : public TNode {
+   public:
+    TJoin(const std::string& name)
+      : TNode(name, 2, 1)
+    {
+    }
+    virtual bool splittable() { return false; }
+    virtual bool operator()()
+    {
+        if (iport(0).empty() or iport(1).empty()) {
+            return false;
+        }
+        int a = boost::any_cast<int>(iport(0).get());
+        int b = boost::any_cast<int>(iport(1).get());
+        Assert(a == b);
+        Pgraph::Data d = a;
+        oport().put(d);
+        return true;
+    }
+};
+
+class TSink : public TNode {
+   public:
+    std::vector<int> got;
+    TSink(const std::string& name)
+      : TNode(name, 1, 0)
+    {
+    }
+    virtual bool take(PortQueues& inputs)
+    {
+        if (iport().empty()) {
+            return false;
+        }
+        inputs.resize(1);
+        inputs[0].push_back(iport().get());
+        return true;
+    }
+    virtual bool compute(PortQueues& inputs, PortQueues& outputs)
+    {
+        got.push_back(boost::any_cast<int>(inputs[0].front()));
+        return true;
+    }
+};
+
+// A call returning false at the node's limit must not strand the
+// rest of its input after its upstream has finished.
+static void test_false_call()
+{
+    const int nobjects = 10;
+    TBurst src("burst", nobjects);
+    TDropFirst drop("drop");
+    TSink sink("sink");
+
+    Pgraph::Graph g;
+    g.connect(&src, &drop);
+    g.connect(&drop, &sink);
+    g.execute_threaded(4);
+
+    Assert(sink.got.size() == (size_t) nobjects - 1);
+    for (int ind = 1; ind < nobjects; ++ind) {
+        Assert(sink.got[ind - 1] == ind);
+    }
+}
+
+int main()
+{
+    test_false_call();
+
+    const int nobjects = 40;
+    const size_t nthreads = 8;
+
+    TSource src1("src1", nobjects), src2("src2", nobjects);
+    TFunction slow1("slow1", 4, 200), slow2("slow2", 0, 200);
+    TFunction fast1("fast1", 1, 1), fast2("fast2", 1, 1);
+    TJoin join("join");
+    TSink sink("sink");
+
+    NodeProfile prof;
+    Pgraph::Graph g;
+    g.set_profile(&prof);
+    g.connect(&src1, &slow1);
+    g.connect(&slow1, &fast1);
+    g.connect(&fast1, &join, 0, 0);
+    g.connect(&src2, &slow2);
+    g.connect(&slow2, &fast2);
+    g.connect(&fast2, &join, 0, 1);
+    g.connect(&join, &sink);
+    Assert(g.connected());
+
+    g.execute_threaded(nthreads);
+
+    std::cerr << "probes: " << g.nprobes() << " calls: " << g.ncalls()
+              << " slow1 max active: " << slow1.maxactive
+              << " slow2 max active: " << slow2.maxactive << "\n";
+
+    Assert(sink.got.size() == (size_t) nobjects);
+    for (int ind = 0; ind < nobjects; ++ind) {
+        Assert(sink.got[ind] == ind);
+    }
+    Assert(slow1.maxactive <= 4);
+    Assert(fast1.maxactive == 1);
+    Assert(fast2.maxactive == 1);
+
+    // Every delivering call is profiled, 8 nodes each called once
+    // per object.
+    auto calls = prof.calls();
+    Assert(calls.size() == 8 * nobjects);
+    Assert(prof.nodes().size() == 8);
+    for (const auto& call : calls) {
+        Assert(call.stop >= call.start);
+    }
+    return 0;
+}
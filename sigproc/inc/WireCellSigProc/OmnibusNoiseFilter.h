@@ -26,7 +26,8 @@ namespace WireCell {
            The Omnibus Noise Filter applies two series of IChannelFilter
            objects. The first series is applied on a per-channel basis and
            the second is applied on groups of channels as determined by
-           its channel grouping.
+           its channel grouping.  Channels and groups may be spread
+           over threads, see "nthreads".
         */
         class OmnibusNoiseFilter : public Aux::Logger,
                                    public WireCell::IFrameFilter,
@@ -64,6 +65,9 @@ namespace WireCell {
 
             std::map<std::string, std::string> m_maskmap;
 
+            // Threads over which to spread channels and groups.
+            int m_nthreads{1};
+
             size_t m_count{0};
         };
 
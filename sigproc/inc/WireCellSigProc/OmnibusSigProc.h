@@ -6,6 +6,7 @@
 #include "WireCellIface/IFrameFilter.h"
 #include "WireCellIface/IConfigurable.h"
 #include "WireCellIface/IAnodePlane.h"
+#include "WireCellIface/IChannelResponse.h"
 #include "WireCellIface/IDFT.h"
 #include "WireCellIface/IWaveform.h"
 
@@ -14,11 +15,15 @@
 
 
 #include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 namespace WireCell {
     namespace SigProc {
 
         class SignalROI;  // forward declaration
+        class ROI_formation;
         class OmnibusSigProc : public Aux::Logger,
                                public WireCell::IFrameFilter, public WireCell::IConfigurable {
            public:
@@ -34,6 +39,9 @@ namespace WireCell {
             // convert data into Eigen Matrix
             void load_data(const input_pointer& in, int plane);
 
+            // Return the "bad" channel masks, empty if there are none.
+            const Waveform::ChannelMasks& bad_masks() const;
+
             // deconvolution
             void decon_2D_init(int plane);  // main decon code
             void decon_2D_ROI_refine(int plane);
@@ -73,6 +81,22 @@ namespace WireCell {
             // initialize the overall response function ...
             void init_overall_response(IFrame::pointer frame);
 
+            // Debug traces saved while processing one plane, indexed
+            // into the plane's own trace vector.
+            struct PlaneTraces {
+                ITrace::vector traces;
+                IFrame::trace_list_t tight_lf, loose_lf, decon_charge;
+            };
+
+            // Load, decon and form the ROIs of one plane.  Touches only
+            // the state of this plane so planes may be run concurrently.
+            void decon_plane(const input_pointer& in, int plane, ROI_formation& roi_form,
+                             const std::vector<float>& perwire_rmses, PlaneTraces& saved);
+
+            // Return the named filter waveform sampled on nbins.  It
+            // is cached until the frame geometry changes.
+            const Waveform::realseq_t& filter_waveform(const std::string& type, const std::string& name, int nbins);
+
             void restore_baseline(WireCell::Array::array_xxf& arr);
 	    void rebase_waveform(WireCell::Array::array_xxf& arr, const int& nbins);
             // This little struct is used to map between WCT channel idents
@@ -121,6 +145,7 @@ namespace WireCell {
             // gain, shaping time, other applification factors
             std::string m_elecresponse_tn{"ColdElec"};
             std::shared_ptr<IWaveform> m_elecresponse;
+            IChannelResponse::pointer m_chan_resp;
             double m_gain{14.0 * units::mV / units::fC};
             double m_shaping_time{2.2 * units::microsecond};
             double m_inter_gain{1.2};
@@ -156,6 +181,9 @@ namespace WireCell {
             // specify the planes to process
             std::vector<int> m_process_planes{0,1,2};
 
+            // number of planes to decon and form ROIs concurrently
+            int m_nthreads{1};
+
             // fixme: this is apparently not used:
             // channel offset
             int m_charge_ch_offset{10000};
@@ -198,6 +226,19 @@ namespace WireCell {
             // average overall responses
             std::vector<Waveform::realseq_t> overall_resp[3];
 
+            // The responses above and everything below derived from
+            // them depend only on the configuration and the frame
+            // geometry: (nticks, period, nwires per plane).  They are
+            // remade only when a frame arrives with a new geometry.
+            std::tuple<int, double, int, int, int> m_resp_key{-1, 0, 0, 0, 0};
+            // 2D spectra of the overall responses, lazily made per plane.
+            Array::array_xxc m_c_resp[3];
+            // Per-channel electronics response corrections, lazily made per plane.
+            Array::array_xxc m_chan_corr[3];
+            // (type, name, nbins) -> filter waveform
+            std::map<std::tuple<std::string, std::string, int>, Waveform::realseq_t> m_filter_cache;
+            std::mutex m_filter_mutex;
+
             // tag name for traces
             std::string m_wiener_tag{"wiener"};
 //            std::string m_wiener_threshold_tag;
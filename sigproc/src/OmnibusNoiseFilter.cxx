@@ -8,11 +8,13 @@
 #include "WireCellAux/SimpleTrace.h"
 
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Parallel.h"
 // #include "WireCellUtil/ExecMon.h" // debugging
 
 #include "WireCellAux/FrameTools.h"
 
 #include <unordered_map>
+#include <unordered_set>
 
 WIRECELL_FACTORY(OmnibusNoiseFilter,
                  WireCell::SigProc::OmnibusNoiseFilter,
@@ -71,6 +73,7 @@ void OmnibusNoiseFilter::configure(const WireCell::Configuration& cfg)
 
     m_intag = get(cfg, "intraces", m_intag);
     m_outtag = get(cfg, "outtraces", m_outtag);
+    m_nthreads = get(cfg, "nthreads", m_nthreads);
 }
 
 WireCell::Configuration OmnibusNoiseFilter::default_configuration() const
@@ -91,6 +94,11 @@ WireCell::Configuration OmnibusNoiseFilter::default_configuration() const
     // The tags for input and output traces
     cfg["intraces"] = m_intag;
     cfg["outtraces"] = m_outtag;
+
+    // Number of threads over which channels and channel groups are
+    // filtered.  More than one requires filters and the noise DB to
+    // be safe to call concurrently (avoid SimpleChannelNoiseDB).
+    cfg["nthreads"] = m_nthreads;
     return cfg;
 }
 
@@ -127,115 +135,163 @@ bool OmnibusNoiseFilter::operator()(const input_pointer& inframe, output_pointer
     Waveform::merge(cmm, input_cmm, m_maskmap);
 
     // Get the ones from database and then merge
-    std::vector<int> bad_channels = m_noisedb->bad_channels();
+    const std::vector<int> bad_channel_list = m_noisedb->bad_channels();
+    const std::unordered_set<int> bad_channels(bad_channel_list.begin(), bad_channel_list.end());
     {
         Waveform::BinRange bad_bins;
         bad_bins.first = 0;
         bad_bins.second = (int) m_nticks;
         Waveform::ChannelMasks temp;
-        for (size_t i = 0; i < bad_channels.size(); i++) {
-            temp[bad_channels.at(i)].push_back(bad_bins);
-            // std::cout << temp.size() << " " << temp[bad_channels.at(i)].size() << std::endl;
+        for (int ch : bad_channel_list) {
+            temp[ch].push_back(bad_bins);
         }
         Waveform::ChannelMaskMap temp_map;
         temp_map["bad"] = temp;
         Waveform::merge(cmm, temp_map, m_maskmap);
     }
 
-    int nchanged_samples = 0;
-
-    // Collect our working area indexed by channel.
-    std::unordered_map<int, Aux::SimpleTrace*> bychan;
+    // Collect our working area as one row per channel.  A channel
+    // seen more than once keeps its last trace.
+    std::unordered_map<int, size_t> rows;
+    rows.reserve(traces.size());
+    std::vector<int> channels;
+    std::vector<ITrace::pointer> intraces;
     for (auto trace : traces) {
-        int ch = trace->channel();
-
-        // make working area directly in simple trace to avoid memory fragmentation
-        auto signal = new Aux::SimpleTrace(ch, 0, m_nticks);
-        bychan[ch] = signal;
-
-        // if good
-        if (find(bad_channels.begin(), bad_channels.end(), ch) == bad_channels.end()) {
-            auto const& charge = trace->charge();
-            const size_t ncharges = charge.size();
+        const int ch = trace->channel();
+        auto it = rows.find(ch);
+        if (it == rows.end()) {
+            rows[ch] = channels.size();
+            channels.push_back(ch);
+            intraces.push_back(trace);
+        }
+        else {
+            intraces[it->second] = trace;
+        }
+    }
+    traces.clear();  // done with our copy of vector of shared pointers
 
-            signal->charge().assign(charge.begin(), charge.begin() + std::min(m_nticks, ncharges));
-            signal->charge().resize(m_nticks, 0.0);
+    const size_t nrows = channels.size();
+    std::vector<IChannelFilter::signal_t> work(nrows);
 
-            if (ncharges != m_nticks) {
-                nchanged_samples += std::abs((int) m_nticks - (int) ncharges);
+    // Masks returned by each job, merged in job order after each
+    // stage so the result does not depend on the thread count.
+    std::vector<std::vector<Waveform::ChannelMaskMap>> job_masks;
+    auto collect = [&](size_t ind, Waveform::ChannelMaskMap&& masks) {
+        if (!masks.empty()) {
+            job_masks[ind].push_back(std::move(masks));
+        }
+    };
+    auto merge_masks = [&]() {
+        for (auto& masks : job_masks) {
+            for (auto& one : masks) {
+                Waveform::merge(cmm, one, m_maskmap);
             }
         }
+        job_masks.clear();
+    };
 
-        int filt_count = 0;
-        for (auto filter : m_perchan) {
-            auto masks = filter->apply(ch, signal->charge());
-
-            // fixme: probably should assure these masks do not lead to out-of-bounds...
-
-            Waveform::merge(cmm, masks, m_maskmap);
-            ++filt_count;
+    int nchanged_samples = 0;
+    for (const auto& trace : intraces) {
+        const size_t ncharges = trace->charge().size();
+        if (ncharges != m_nticks && bad_channels.find(trace->channel()) == bad_channels.end()) {
+            nchanged_samples += std::abs((int) m_nticks - (int) ncharges);
         }
     }
-    traces.clear();  // done with our copy of vector of shared pointers
-
     if (nchanged_samples) {
         log->warn("warning, truncated or extended {} samples", nchanged_samples);
     }
 
-    int group_counter = 0;
-    int nunknownchans = 0;
-    for (auto group : m_noisedb->coherent_channels()) {
-        ++group_counter;
-
-        int flag = 1;
+    job_masks.resize(nrows);
+    parallel_for(nrows, [&](size_t row) {
+        const int ch = channels[row];
+        auto& signal = work[row];
+        if (bad_channels.find(ch) == bad_channels.end()) {
+            auto const& charge = intraces[row]->charge();
+            signal.assign(charge.begin(), charge.begin() + std::min(m_nticks, charge.size()));
+        }
+        signal.resize(m_nticks, 0.0);
+        intraces[row] = nullptr;
 
-        IChannelFilter::channel_signals_t chgrp;
-        for (auto ch : group) {  // fix me: check if we don't actually have this channel
-                                 // std::cout << group_counter << " " << ch << " " << std::endl;
-            if (bychan.find(ch) == bychan.end()) {
-                ++nunknownchans;
-                flag = 0;
+        for (auto filter : m_perchan) {
+            // fixme: probably should assure these masks do not lead to out-of-bounds...
+            collect(row, filter->apply(ch, signal));
+        }
+    }, m_nthreads);
+    merge_masks();
+    intraces.clear();
+
+    // Groups missing any channel are skipped (probably the channel
+    // selector is in use).  Groups sharing a channel must run serially.
+    const auto& groups = m_noisedb->coherent_channels();
+    std::vector<size_t> known;
+    int nunknownchans = 0;
+    bool overlap = false;
+    {
+        std::vector<char> used(nrows, 0);
+        for (size_t igroup = 0; igroup < groups.size(); ++igroup) {
+            int nunknown = 0;
+            for (auto ch : groups[igroup]) {
+                if (rows.find(ch) == rows.end()) {
+                    ++nunknown;
+                }
+            }
+            nunknownchans += nunknown;
+            if (nunknown) {
+                continue;
             }
-            else {
-                chgrp[ch] = bychan[ch]->charge();  // copy...
+            known.push_back(igroup);
+            for (auto ch : groups[igroup]) {
+                char& flag = used[rows[ch]];
+                overlap = overlap or flag;
+                flag = 1;
             }
         }
+    }
+    if (overlap and m_nthreads > 1) {
+        log->debug("coherent channel groups overlap, running grouped filters serially");
+    }
 
-        if (flag == 0) continue;
+    job_masks.resize(known.size());
+    parallel_for(known.size(), [&](size_t ind) {
+        IChannelFilter::channel_signals_t chgrp;
+        for (auto ch : groups[known[ind]]) {
+            // A channel listed twice must not be moved twice.
+            if (chgrp.find(ch) == chgrp.end()) {
+                chgrp[ch] = std::move(work[rows.at(ch)]);
+            }
+        }
 
         for (auto filter : m_grouped) {
-            auto masks = filter->apply(chgrp);
-
-            Waveform::merge(cmm, masks, m_maskmap);
+            collect(ind, filter->apply(chgrp));
         }
 
-        for (auto cs : chgrp) {
-            // cs.second; // copy
-            bychan[cs.first]->charge().assign(cs.second.begin(), cs.second.end());
+        for (auto& cs : chgrp) {
+            work[rows.at(cs.first)] = std::move(cs.second);
         }
-    }
+    }, overlap ? 1 : m_nthreads);
+    merge_masks();
 
     if (nunknownchans) {
         log->debug("{} unknown channels (probably the channel selector is in use)", nunknownchans);
     }
 
     // run status
-    for (auto& it : bychan) {
-        const int ch = it.first;
-        IChannelFilter::signal_t& signal = it.second->charge();
+    job_masks.resize(nrows);
+    parallel_for(nrows, [&](size_t row) {
         for (auto filter : m_perchan_status) {
-            auto masks = filter->apply(ch, signal);
-
-            Waveform::merge(cmm, masks, m_maskmap);
+            collect(row, filter->apply(channels[row], work[row]));
         }
+    }, m_nthreads);
+    merge_masks();
+
+    // Hand each row to its output trace without copying.
+    ITrace::vector itraces(nrows);
+    for (size_t row = 0; row < nrows; ++row) {  // fixme: that tbin though
+        auto trace = std::make_shared<Aux::SimpleTrace>(channels[row], 0, 0);
+        trace->charge().swap(work[row]);
+        itraces[row] = trace;
     }
-
-    ITrace::vector itraces;
-    for (auto& cs : bychan) {  // fixme: that tbin though
-        itraces.push_back(ITrace::pointer(cs.second));
-    }
-
-    bychan.clear();
+    work.clear();
 
     auto sframe = new Aux::SimpleFrame(inframe->ident(), inframe->time(), itraces, inframe->tick(), cmm);
     IFrame::trace_list_t indices(itraces.size());
@@ -18,9 +18,11 @@
 #include "WireCellUtil/String.h"
 #include "WireCellUtil/FFTBestLength.h"
 #include "WireCellUtil/Waveform.h"
+#include "WireCellUtil/Parallel.h"
 
 #include "WireCellUtil/NamedFactory.h"
 
+
 WIRECELL_FACTORY(OmnibusSigProc, WireCell::SigProc::OmnibusSigProc,
                  WireCell::INamed,
                  WireCell::IFrameFilter, WireCell::IConfigurable)
@@ -73,6 +75,7 @@ void OmnibusSigProc::configure(const WireCell::Configuration& config)
     }
 
     m_fft_flag = get(config, "fft_flag", m_fft_flag);
+    m_nthreads = get(config, "nthreads", m_nthreads);
     if (m_fft_flag) {
       m_fft_flag = 0;
       log->warn("config: fft_flag option is broken, will use native array sizes");
@@ -165,6 +168,15 @@ void OmnibusSigProc::configure(const WireCell::Configuration& config)
     //
     m_elecresponse = Factory::find_tn<IWaveform>(m_elecresponse_tn);
 
+    // Found here so planes decon'ed concurrently need no lookup.
+    m_chan_resp = nullptr;
+    if (!m_per_chan_resp.empty()) {
+        m_chan_resp = Factory::find_tn<IChannelResponse>(m_per_chan_resp);
+    }
+
+    // responses are remade on the next frame
+    m_resp_key = std::make_tuple(-1, 0.0, 0, 0, 0);
+
     // Build up the channel map.  The OSP channel must run contiguously
     // first up the U, then V, then W "wires".  Ie, face-major order,
     // but we have plane-major order so make a temporary collection.
@@ -230,6 +242,11 @@ WireCell::Configuration OmnibusSigProc::default_configuration() const
     //cfg["fft_flag"] = m_fft_flag;
     cfg["fft_flag"] = 0;
 
+    // If more than one, planes are deconvolved and their ROIs are
+    // formed concurrently.  Multi-plane ROI and refinement steps
+    // always run serially after all planes are done.
+    cfg["nthreads"] = m_nthreads;
+
     cfg["elecresponse"] = m_elecresponse_tn;
     cfg["gain"] = m_gain;
     cfg["shaping"] = m_shaping_time;
@@ -301,18 +318,32 @@ WireCell::Configuration OmnibusSigProc::default_configuration() const
     return cfg;
 }
 
+const Waveform::ChannelMasks& OmnibusSigProc::bad_masks() const
+{
+    static const Waveform::ChannelMasks none;
+    auto it = m_wanmm.find("bad");
+    if (it == m_wanmm.end()) {
+        return none;
+    }
+    return it->second;
+}
+
 void OmnibusSigProc::load_data(const input_pointer& in, int plane)
 {
     m_r_data[plane] = Array::array_xxf::Zero(m_fft_nwires[plane], m_fft_nticks);
 
     auto traces = in->traces();
 
-    auto& bad = m_wanmm["bad"];
+    const auto& bad = bad_masks();
     int nbad = 0;
 
     for (auto trace : *traces.get()) {
         int wct_channel_ident = trace->channel();
-        OspChan och = m_channel_map[wct_channel_ident];
+        auto chit = m_channel_map.find(wct_channel_ident);
+        if (chit == m_channel_map.end()) {
+            continue;  // in case user gives us multi apa frame
+        }
+        const OspChan& och = chit->second;
         if (plane != och.plane) {
             continue;  // we'll catch it in another call to load_data
         }
@@ -405,7 +436,7 @@ void OmnibusSigProc::save_data(
             }
         }
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = bad_masks();
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -511,7 +542,7 @@ void OmnibusSigProc::save_roi(ITrace::vector& itraces, IFrame::trace_list_t& ind
         }
 
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = bad_masks();
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -594,7 +625,7 @@ void OmnibusSigProc::save_ext_roi(ITrace::vector& itraces, IFrame::trace_list_t&
         }
 
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = bad_masks();
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -662,7 +693,7 @@ void OmnibusSigProc::save_mproi(ITrace::vector& itraces, IFrame::trace_list_t& i
         }
 
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = bad_masks();
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -721,6 +752,18 @@ void OmnibusSigProc::init_overall_response(IFrame::pointer frame)
         m_nticks = tbinmax - tbinmin;
         log->debug("call={} init nticks={} tbinmin={} tbinmax={}", m_count, m_nticks, tbinmin, tbinmax);
 
+        const auto key = std::make_tuple(m_nticks, m_period, m_nwires[0], m_nwires[1], m_nwires[2]);
+        if (key == m_resp_key) {
+            return;
+        }
+        log->debug("call={} remake responses for nticks={} period={}", m_count, m_nticks, m_period);
+        m_resp_key = key;
+        for (int i = 0; i != 3; i++) {
+            m_c_resp[i].resize(0, 0);
+            m_chan_corr[i].resize(0, 0);
+        }
+        m_filter_cache.clear();
+
         if (m_fft_flag == 0) {
             m_fft_nticks = m_nticks;
         }
@@ -864,6 +907,19 @@ void OmnibusSigProc::init_overall_response(IFrame::pointer frame)
     }  //  loop over plane
 }
 
+const Waveform::realseq_t& OmnibusSigProc::filter_waveform(const std::string& type, const std::string& name,
+                                                            int nbins)
+{
+    const auto key = std::make_tuple(type, name, nbins);
+    std::lock_guard<std::mutex> lock(m_filter_mutex);
+    auto it = m_filter_cache.find(key);
+    if (it == m_filter_cache.end()) {
+        auto filter = Factory::find<IFilterWaveform>(type, name);
+        it = m_filter_cache.emplace(key, filter->filter_waveform(nbins)).first;
+    }
+    return it->second;
+}
+
 void OmnibusSigProc::restore_baseline(Array::array_xxf& arr)
 {
     int nempty=0;
@@ -948,63 +1004,70 @@ void OmnibusSigProc::decon_2D_init(int plane)
     m_c_data[plane] = fwd_r2c(m_dft, m_r_data[plane], 1);
 
     // now apply the ch-by-ch response ...
-    if (!m_per_chan_resp.empty()) {
+    if (m_chan_resp) {
         log->debug("call={} applying ch-by-ch electronics response correction", m_count);
-        auto cr = Factory::find_tn<IChannelResponse>(m_per_chan_resp);
-        auto cr_bins = cr->channel_response_binning();
-        if (cr_bins.binsize() != m_period) {
-            log->critical("call={} decon_2D_init: channel response size mismatch", m_count);
-            THROW(ValueError() << errmsg{"OmnibusSigProc::decon_2D_init: channel response size mismatch"});
-        }
+        auto& corr = m_chan_corr[plane];
+        if (!corr.size()) {
+            const auto& cr = m_chan_resp;
+            auto cr_bins = cr->channel_response_binning();
+            if (cr_bins.binsize() != m_period) {
+                log->critical("call={} decon_2D_init: channel response size mismatch", m_count);
+                THROW(ValueError() << errmsg{"OmnibusSigProc::decon_2D_init: channel response size mismatch"});
+            }
 
-        WireCell::Binning tbins(m_fft_nticks, cr_bins.min(), cr_bins.min() + m_fft_nticks * m_period);
+            WireCell::Binning tbins(m_fft_nticks, cr_bins.min(), cr_bins.min() + m_fft_nticks * m_period);
 
-        auto ewave = (*m_elecresponse).waveform_samples(tbins);
-        const WireCell::Waveform::compseq_t elec = fwd_r2c(m_dft, ewave);
+            auto ewave = (*m_elecresponse).waveform_samples(tbins);
+            const WireCell::Waveform::compseq_t elec = fwd_r2c(m_dft, ewave);
 
-        for (auto och : m_channel_range[plane]) {
-            // const auto& ch_resp = cr->channel_response(och.ident);
-            Waveform::realseq_t tch_resp = cr->channel_response(och.ident);
-            tch_resp.resize(m_fft_nticks, 0);
-            const WireCell::Waveform::compseq_t ch_elec = fwd_r2c(m_dft, tch_resp);
+            // Rows without a channel are left as they are.
+            corr = Array::array_xxc::Ones(m_c_data[plane].rows(), m_c_data[plane].cols());
+            for (auto och : m_channel_range[plane]) {
+                // const auto& ch_resp = cr->channel_response(och.ident);
+                Waveform::realseq_t tch_resp = cr->channel_response(och.ident);
+                tch_resp.resize(m_fft_nticks, 0);
+                const WireCell::Waveform::compseq_t ch_elec = fwd_r2c(m_dft, tch_resp);
 
-            const int irow = och.wire + m_pad_nwires[plane];
-            for (int icol = 0; icol != m_c_data[plane].cols(); icol++) {
-                const auto four = ch_elec.at(icol);
-                if (std::abs(four) != 0) {
-                    m_c_data[plane](irow, icol) *= elec.at(icol) / four;
-                }
-                else {
-                    m_c_data[plane](irow, icol) = 0;
+                const int irow = och.wire + m_pad_nwires[plane];
+                for (int icol = 0; icol != corr.cols(); icol++) {
+                    const auto four = ch_elec.at(icol);
+                    if (std::abs(four) != 0) {
+                        corr(irow, icol) = elec.at(icol) / four;
+                    }
+                    else {
+                        corr(irow, icol) = 0;
+                    }
                 }
             }
         }
+        m_c_data[plane] *= corr;
     }
 
     // second round of FFT on wire
     m_c_data[plane] = fwd(m_dft, m_c_data[plane], 0);
 
     // response part ...
-    Array::array_xxf r_resp = Array::array_xxf::Zero(m_r_data[plane].rows(), m_fft_nticks);
-    for (size_t i = 0; i != overall_resp[plane].size(); i++) {
-        for (int j = 0; j != m_fft_nticks; j++) {
-            r_resp(i, j) = overall_resp[plane].at(i).at(j);
+    auto& c_resp = m_c_resp[plane];
+    if (!c_resp.size()) {
+        Array::array_xxf r_resp = Array::array_xxf::Zero(m_r_data[plane].rows(), m_fft_nticks);
+        for (size_t i = 0; i != overall_resp[plane].size(); i++) {
+            for (int j = 0; j != m_fft_nticks; j++) {
+                r_resp(i, j) = overall_resp[plane].at(i).at(j);
+            }
         }
-    }
 
-    // do first round FFT on the resposne on time
-    Array::array_xxc c_resp = fwd_r2c(m_dft, r_resp, 1);
-    // do second round FFT on the response on wire
-    c_resp = fwd(m_dft, c_resp, 0);
+        // do first round FFT on the resposne on time
+        c_resp = fwd_r2c(m_dft, r_resp, 1);
+        // do second round FFT on the response on wire
+        c_resp = fwd(m_dft, c_resp, 0);
+    }
 
     // make ratio to the response and apply wire filter
     m_c_data[plane] = m_c_data[plane] / c_resp;
 
     // apply software filter on wire
     const std::vector<std::string> filter_names{"Wire_ind", "Wire_ind", "Wire_col"};
-    Waveform::realseq_t wire_filter_wf;
-    auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", filter_names[plane]);
-    wire_filter_wf = ncr1->filter_waveform(m_c_data[plane].rows());
+    const auto& wire_filter_wf = filter_waveform("HfFilter", filter_names[plane], m_c_data[plane].rows());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             float val = abs(m_c_data[plane](irow, icol));
@@ -1057,8 +1120,7 @@ void OmnibusSigProc::decon_2D_ROI_refine(int plane)
     const std::vector<std::string> filter_names{"Wiener_tight_U", "Wiener_tight_V", "Wiener_tight_W"};
     Waveform::realseq_t roi_hf_filter_wf;
 
-    auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", filter_names[plane]);
-    roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+    roi_hf_filter_wf = filter_waveform("HfFilter", filter_names[plane], m_c_data[plane].cols());
 
     Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
@@ -1080,26 +1142,21 @@ void OmnibusSigProc::decon_2D_tightROI(int plane)
 
     Waveform::realseq_t roi_hf_filter_wf;
     if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_U", m_c_data[plane].cols());
+        const auto& temp_filter = filter_waveform("LfFilter", "ROI_tight_lf", m_c_data[plane].cols());
         for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
             roi_hf_filter_wf.at(i) *= temp_filter.at(i);
         }
     }
     else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_V", m_c_data[plane].cols());
+        const auto& temp_filter = filter_waveform("LfFilter", "ROI_tight_lf", m_c_data[plane].cols());
         for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
             roi_hf_filter_wf.at(i) *= temp_filter.at(i);
         }
     }
     else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_W", m_c_data[plane].cols());
     }
 
     Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
@@ -1123,26 +1180,21 @@ void OmnibusSigProc::decon_2D_tighterROI(int plane)
 
     Waveform::realseq_t roi_hf_filter_wf;
     if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tighter_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_U", m_c_data[plane].cols());
+        const auto& temp_filter = filter_waveform("LfFilter", "ROI_tighter_lf", m_c_data[plane].cols());
         for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
             roi_hf_filter_wf.at(i) *= temp_filter.at(i);
         }
     }
     else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tighter_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_V", m_c_data[plane].cols());
+        const auto& temp_filter = filter_waveform("LfFilter", "ROI_tighter_lf", m_c_data[plane].cols());
         for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
             roi_hf_filter_wf.at(i) *= temp_filter.at(i);
         }
     }
     else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_W", m_c_data[plane].cols());
     }
 
     Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
@@ -1171,46 +1223,39 @@ void OmnibusSigProc::decon_2D_looseROI(int plane)
     Waveform::realseq_t roi_hf_filter_wf1;
     Waveform::realseq_t roi_hf_filter_wf2;
     if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_U", m_c_data[plane].cols());
         roi_hf_filter_wf1 = roi_hf_filter_wf;
         {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+            const auto& temp_filter = filter_waveform("LfFilter", "ROI_loose_lf", m_c_data[plane].cols());
             for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
                 roi_hf_filter_wf.at(i) *= temp_filter.at(i);
             }
         }
         {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+            const auto& temp_filter = filter_waveform("LfFilter", "ROI_tight_lf", m_c_data[plane].cols());
             for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
                 roi_hf_filter_wf1.at(i) *= temp_filter.at(i);
             }
         }
     }
     else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_V", m_c_data[plane].cols());
         roi_hf_filter_wf1 = roi_hf_filter_wf;
         {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+            const auto& temp_filter = filter_waveform("LfFilter", "ROI_loose_lf", m_c_data[plane].cols());
             for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
                 roi_hf_filter_wf.at(i) *= temp_filter.at(i);
             }
         }
         {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+            const auto& temp_filter = filter_waveform("LfFilter", "ROI_tight_lf", m_c_data[plane].cols());
             for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
                 roi_hf_filter_wf1.at(i) *= temp_filter.at(i);
             }
         }
     }
     else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_W", m_c_data[plane].cols());
     }
 
     const int n_lfn_nn = 2;
@@ -1247,26 +1292,21 @@ void OmnibusSigProc::decon_2D_looseROI_debug_mode(int plane)
 
     Waveform::realseq_t roi_hf_filter_wf;
     if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_U", m_c_data[plane].cols());
+        const auto& temp_filter = filter_waveform("LfFilter", "ROI_loose_lf", m_c_data[plane].cols());
         for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
             roi_hf_filter_wf.at(i) *= temp_filter.at(i);
         }
     }
     else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_V", m_c_data[plane].cols());
+        const auto& temp_filter = filter_waveform("LfFilter", "ROI_loose_lf", m_c_data[plane].cols());
         for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
             roi_hf_filter_wf.at(i) *= temp_filter.at(i);
         }
     }
     else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_tight_W", m_c_data[plane].cols());
     }
 
     Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
@@ -1304,7 +1344,11 @@ bool OmnibusSigProc::masked_neighbors(const std::string& cmname, OspChan& ochan,
         return false;
     }
 
-    auto& cm = m_wanmm[cmname];
+    auto cmit = m_wanmm.find(cmname);
+    if (cmit == m_wanmm.end()) {
+        return false;
+    }
+    const auto& cm = cmit->second;
     for (int och = lo_chan; och <= hi_chan; ++och) {
         if (cm.find(och) != cm.end()) {
             return true;
@@ -1319,16 +1363,13 @@ void OmnibusSigProc::decon_2D_hits(int plane)
 
     Waveform::realseq_t roi_hf_filter_wf;
     if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_wide_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_wide_U", m_c_data[plane].cols());
     }
     else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_wide_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_wide_V", m_c_data[plane].cols());
     }
     else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_wide_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Wiener_wide_W", m_c_data[plane].cols());
     }
 
     Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
@@ -1352,16 +1393,13 @@ void OmnibusSigProc::decon_2D_charge(int plane)
 
     Waveform::realseq_t roi_hf_filter_wf;
     if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Gaus_wide");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Gaus_wide", m_c_data[plane].cols());
     }
     else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Gaus_wide");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Gaus_wide", m_c_data[plane].cols());
     }
     else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Gaus_wide");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+        roi_hf_filter_wf = filter_waveform("HfFilter", "Gaus_wide", m_c_data[plane].cols());
     }
 
     Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
@@ -1379,6 +1417,77 @@ void OmnibusSigProc::decon_2D_charge(int plane)
     }
 }
 
+void OmnibusSigProc::decon_plane(const input_pointer& in, int iplane, ROI_formation& roi_form,
+                                 const std::vector<float>& perwire_rmses, PlaneTraces& saved)
+{
+    // load data into EIGEN matrices ...
+    load_data(in, iplane);  // load into a large matrix
+    // initial decon ...
+    decon_2D_init(iplane);  // decon in large matrix
+    check_data(iplane, "after 2D init");
+
+    // Form tight ROIs
+    if (iplane != 2) {  // induction wire planes
+        if (m_use_roi_refinement) {
+            decon_2D_tighterROI(iplane);
+            Array::array_xxf r_data_tight = m_r_data[iplane];
+            //      r_data_tight = m_r_data[plane];
+            decon_2D_tightROI(iplane);
+            roi_form.find_ROI_by_decon_itself(iplane, m_r_data[iplane], r_data_tight);
+        }
+    }
+    else {  // collection wire planes
+        decon_2D_tightROI(iplane);
+        roi_form.find_ROI_by_decon_itself(iplane, m_r_data[iplane]);
+    }
+    check_data(iplane, "after 2D tight ROI");
+
+    // save_data passes perwire_rmses to dummy, which will not be used
+    std::vector<double> dummy;
+    // [wgu] save decon result after tight LF
+    if (m_use_roi_debug_mode and !m_tight_lf_tag.empty()) {
+        save_data(saved.traces, saved.tight_lf, iplane, perwire_rmses, dummy, "tight_lf");
+    }
+
+    // Form loose ROIs
+    if (iplane != 2) {
+        // [wgu] save decon result after loose LF
+        if (m_use_roi_debug_mode) {
+            decon_2D_looseROI_debug_mode(iplane);
+            if (!m_loose_lf_tag.empty()) {
+                save_data(saved.traces, saved.loose_lf, iplane, perwire_rmses, dummy, "loose_lf");
+            }
+        }
+
+        if (m_use_roi_refinement) {
+            decon_2D_looseROI(iplane);
+            roi_form.find_ROI_loose(iplane, m_r_data[iplane]);
+            decon_2D_ROI_refine(iplane);
+        }
+    }
+
+    // [wgu] collection plane does not need loose LF
+    // but save something to be consistent
+    if (m_use_roi_debug_mode and iplane == 2) {
+        if (!m_loose_lf_tag.empty()) {
+            save_data(saved.traces, saved.loose_lf, iplane, perwire_rmses, dummy, "loose_lf");
+        }
+    }
+
+    check_data(iplane, "after 2D ROI refine");
+
+    if (!m_use_roi_refinement) {
+        /// TODO: streamline the logics
+        // special case to dump decon without needs of ROIs
+        if (m_use_roi_debug_mode and !m_decon_charge_tag.empty()) {
+            decon_2D_charge(iplane);
+            save_data(saved.traces, saved.decon_charge, iplane, perwire_rmses, dummy, "decon");
+        }
+        m_c_data[iplane].resize(0, 0);  // clear memory
+        m_r_data[iplane].resize(0, 0);  // clear memory
+    }
+}
+
 bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
 {
     out = nullptr;
@@ -1440,79 +1549,37 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
     const std::vector<float>* perplane_thresholds[3] = {&roi_form.get_uplane_rms(), &roi_form.get_vplane_rms(),
                                                         &roi_form.get_wplane_rms()};
 
+    // Per-plane work is independent up to here.  The planes only
+    // read the mask map, see bad_masks().
+    std::vector<int> planes;
     for (int iplane = 0; iplane != 3; ++iplane) {
         auto it = std::find(m_process_planes.begin(), m_process_planes.end(), iplane);
         if (it == m_process_planes.end()) continue;
-        const std::vector<float>& perwire_rmses = *perplane_thresholds[iplane];
-
-        // load data into EIGEN matrices ...
-        load_data(in, iplane);  // load into a large matrix
-        // initial decon ...
-        decon_2D_init(iplane);  // decon in large matrix
-        check_data(iplane, "after 2D init");
-
-        // Form tight ROIs
-        if (iplane != 2) {  // induction wire planes
-            if (m_use_roi_refinement) {
-                decon_2D_tighterROI(iplane);
-                Array::array_xxf r_data_tight = m_r_data[iplane];
-                //      r_data_tight = m_r_data[plane];
-                decon_2D_tightROI(iplane);
-                roi_form.find_ROI_by_decon_itself(iplane, m_r_data[iplane], r_data_tight);
-            }
-        }
-        else {  // collection wire planes
-            decon_2D_tightROI(iplane);
-            roi_form.find_ROI_by_decon_itself(iplane, m_r_data[iplane]);
-        }
-        check_data(iplane, "after 2D tight ROI");
-
-        // save_data passes perwire_rmses to dummy, which will not be used
-        std::vector<double> dummy;
-        // [wgu] save decon result after tight LF
-        if (m_use_roi_debug_mode and !m_tight_lf_tag.empty()) {
-            save_data(*itraces, tight_lf_traces, iplane, perwire_rmses, dummy, "tight_lf");
-        }
-
-        // Form loose ROIs
-        if (iplane != 2) {
-            // [wgu] save decon result after loose LF
-            if (m_use_roi_debug_mode) {
-                decon_2D_looseROI_debug_mode(iplane);
-                if (!m_loose_lf_tag.empty()) {
-                    save_data(*itraces, loose_lf_traces, iplane, perwire_rmses, dummy, "loose_lf");
-                }
+        planes.push_back(iplane);
+    }
+    PlaneTraces saved[3];
+    auto run_plane = [&](int iplane) {
+        decon_plane(in, iplane, roi_form, *perplane_thresholds[iplane], saved[iplane]);
+    };
+
+    parallel_for(planes.size(), [&](size_t ind) { run_plane(planes[ind]); }, m_nthreads);
+
+    // Merge in plane order so output does not depend on scheduling.
+    for (int iplane : planes) {
+        auto& one = saved[iplane];
+        const size_t offset = itraces->size();
+        itraces->insert(itraces->end(), one.traces.begin(), one.traces.end());
+        auto append = [&](const IFrame::trace_list_t& src, IFrame::trace_list_t& dst) {
+            for (auto ind : src) {
+                dst.push_back(ind + offset);
             }
-
-            if (m_use_roi_refinement) {
-                decon_2D_looseROI(iplane);
-                roi_form.find_ROI_loose(iplane, m_r_data[iplane]);
-                decon_2D_ROI_refine(iplane);
-            }
-        }
-
-        // [wgu] collection plane does not need loose LF
-        // but save something to be consistent
-        if (m_use_roi_debug_mode and iplane == 2) {
-            if (!m_loose_lf_tag.empty()) {
-                save_data(*itraces, loose_lf_traces, iplane, perwire_rmses, dummy, "loose_lf");
-            }
-        }
-
-        check_data(iplane, "after 2D ROI refine");
+        };
+        append(one.tight_lf, tight_lf_traces);
+        append(one.loose_lf, loose_lf_traces);
+        append(one.decon_charge, decon_charge_traces);
 
         // Refine ROIs
         if (m_use_roi_refinement) roi_refine.load_data(iplane, m_r_data[iplane], roi_form);
-        else {
-            /// TODO: streamline the logics
-            // special case to dump decon without needs of ROIs
-            if (m_use_roi_debug_mode and !m_decon_charge_tag.empty()) {
-                decon_2D_charge(iplane);
-                save_data(*itraces, decon_charge_traces, iplane, perwire_rmses, dummy, "decon");
-            }
-            m_c_data[iplane].resize(0, 0);  // clear memory
-            m_r_data[iplane].resize(0, 0);  // clear memory
-        }
     }
 
     if (m_use_roi_refinement) {
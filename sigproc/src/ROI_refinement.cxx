@@ -1,5 +1,6 @@
 #include "ROI_refinement.h"
 #include "PeakFinding.h"
+#include <algorithm>
 #include <iostream>
 #include <set>
 
@@ -82,37 +83,25 @@ ROI_refinement::~ROI_refinement() { Clear(); }
 void ROI_refinement::Clear()
 {
     for (int i = 0; i != nwire_u; i++) {
-        for (auto it = rois_u_tight.at(i).begin(); it != rois_u_tight.at(i).end(); it++) {
-            delete *it;
-        }
         rois_u_tight.at(i).clear();
-        for (auto it = rois_u_loose.at(i).begin(); it != rois_u_loose.at(i).end(); it++) {
-            delete *it;
-        }
         rois_u_loose.at(i).clear();
     }
 
     for (int i = 0; i != nwire_v; i++) {
-        for (auto it = rois_v_tight.at(i).begin(); it != rois_v_tight.at(i).end(); it++) {
-            delete *it;
-        }
         rois_v_tight.at(i).clear();
-        for (auto it = rois_v_loose.at(i).begin(); it != rois_v_loose.at(i).end(); it++) {
-            delete *it;
-        }
         rois_v_loose.at(i).clear();
     }
 
     for (int i = 0; i != nwire_w; i++) {
-        for (auto it = rois_w_tight.at(i).begin(); it != rois_w_tight.at(i).end(); it++) {
-            delete *it;
-        }
         rois_w_tight.at(i).clear();
     }
 
     front_rois.clear();
     back_rois.clear();
     contained_rois.clear();
+
+    // the pool owns all ROIs
+    roi_pool.clear();
 }
 
 void ROI_refinement::apply_roi(int plane, Array::array_xxf &r_data)
@@ -231,12 +220,12 @@ void ROI_refinement::unlink(SignalROI *prev_roi, SignalROI *next_roi)
 {
     if (front_rois.find(prev_roi) != front_rois.end()) {
         SignalROISelection &temp_rois = front_rois[prev_roi];
-        auto it = find(temp_rois.begin(), temp_rois.end(), next_roi);
+        auto it = std::find(temp_rois.begin(), temp_rois.end(), next_roi);
         if (it != temp_rois.end()) temp_rois.erase(it);
     }
     if (back_rois.find(next_roi) != back_rois.end()) {
         SignalROISelection &temp_rois = back_rois[next_roi];
-        auto it = find(temp_rois.begin(), temp_rois.end(), prev_roi);
+        auto it = std::find(temp_rois.begin(), temp_rois.end(), prev_roi);
         if (it != temp_rois.end()) temp_rois.erase(it);
     }
 }
@@ -245,7 +234,7 @@ void ROI_refinement::link(SignalROI *prev_roi, SignalROI *next_roi)
 {
     if (front_rois.find(prev_roi) != front_rois.end()) {
         SignalROISelection &temp_rois = front_rois[prev_roi];
-        auto it = find(temp_rois.begin(), temp_rois.end(), next_roi);
+        auto it = std::find(temp_rois.begin(), temp_rois.end(), next_roi);
         if (it == temp_rois.end()) temp_rois.push_back(next_roi);
     }
     else {
@@ -256,7 +245,7 @@ void ROI_refinement::link(SignalROI *prev_roi, SignalROI *next_roi)
 
     if (back_rois.find(next_roi) != back_rois.end()) {
         SignalROISelection &temp_rois = back_rois[next_roi];
-        auto it = find(temp_rois.begin(), temp_rois.end(), prev_roi);
+        auto it = std::find(temp_rois.begin(), temp_rois.end(), prev_roi);
         if (it == temp_rois.end()) temp_rois.push_back(prev_roi);
     }
     else {
@@ -316,10 +305,10 @@ void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_fo
         std::vector<std::pair<int, int>> &uboone_rois = roi_form.get_self_rois(irow + offset);
         for (size_t i = 0; i != uboone_rois.size(); i++) {
             SignalROI *tight_roi =
-                new SignalROI(plane, irow + offset, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
+                roi_pool.make(plane, irow + offset, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
             float threshold = plane_rms.at(irow) * th_factor;
             if (tight_roi->get_above_threshold(threshold).size() == 0) {
-                delete tight_roi;
+                roi_pool.release(tight_roi);
                 continue;
             }
 
@@ -490,10 +479,10 @@ void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_fo
             uboone_rois = roi_form.get_loose_rois(chid);
             for (size_t i = 0; i != uboone_rois.size(); i++) {
                 SignalROI *loose_roi =
-                    new SignalROI(plane, chid, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
+                    roi_pool.make(plane, chid, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
                 float threshold = plane_rms.at(irow) * th_factor;
                 if (loose_roi->get_above_threshold(threshold).size() == 0) {
-                    delete loose_roi;
+                    roi_pool.release(loose_roi);
                     continue;
                 }
                 if (plane == 0) {
@@ -760,7 +749,7 @@ void ROI_refinement::CleanUpROIs(int plane)
                     // check front map
                     if (front_rois.find(roi) != front_rois.end()) {
                         for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
-                            auto it2 = find(back_rois[*it1].begin(), back_rois[*it1].end(), roi);
+                            auto it2 = std::find(back_rois[*it1].begin(), back_rois[*it1].end(), roi);
                             back_rois[*it1].erase(it2);
                         }
                         front_rois.erase(roi);
@@ -768,7 +757,7 @@ void ROI_refinement::CleanUpROIs(int plane)
                     // check back map
                     if (back_rois.find(roi) != back_rois.end()) {
                         for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
-                            auto it2 = find(front_rois[*it1].begin(), front_rois[*it1].end(), roi);
+                            auto it2 = std::find(front_rois[*it1].begin(), front_rois[*it1].end(), roi);
                             front_rois[*it1].erase(it2);
                         }
                         back_rois.erase(roi);
@@ -777,9 +766,9 @@ void ROI_refinement::CleanUpROIs(int plane)
             }
 
             for (auto it = to_be_removed.begin(); it != to_be_removed.end(); it++) {
-                auto it1 = find(rois_u_loose.at(i).begin(), rois_u_loose.at(i).end(), *it);
+                auto it1 = std::find(rois_u_loose.at(i).begin(), rois_u_loose.at(i).end(), *it);
                 rois_u_loose.at(i).erase(it1);
-                delete (*it);
+                roi_pool.release(*it);
             }
         }
     }
@@ -840,7 +829,7 @@ void ROI_refinement::CleanUpROIs(int plane)
                     // check front map
                     if (front_rois.find(roi) != front_rois.end()) {
                         for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
-                            auto it2 = find(back_rois[*it1].begin(), back_rois[*it1].end(), roi);
+                            auto it2 = std::find(back_rois[*it1].begin(), back_rois[*it1].end(), roi);
                             back_rois[*it1].erase(it2);
                         }
                         front_rois.erase(roi);
@@ -848,7 +837,7 @@ void ROI_refinement::CleanUpROIs(int plane)
                     // check back map
                     if (back_rois.find(roi) != back_rois.end()) {
                         for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
-                            auto it2 = find(front_rois[*it1].begin(), front_rois[*it1].end(), roi);
+                            auto it2 = std::find(front_rois[*it1].begin(), front_rois[*it1].end(), roi);
                             front_rois[*it1].erase(it2);
                         }
                         back_rois.erase(roi);
@@ -857,9 +846,9 @@ void ROI_refinement::CleanUpROIs(int plane)
             }
 
             for (auto it = to_be_removed.begin(); it != to_be_removed.end(); it++) {
-                auto it1 = find(rois_v_loose.at(i).begin(), rois_v_loose.at(i).end(), *it);
+                auto it1 = std::find(rois_v_loose.at(i).begin(), rois_v_loose.at(i).end(), *it);
                 rois_v_loose.at(i).erase(it1);
-                delete (*it);
+                roi_pool.release(*it);
             }
         }
     }
@@ -902,7 +891,7 @@ void ROI_refinement::generate_merge_ROIs(int plane)
             for (auto it = saved_rois.begin(); it != saved_rois.end(); it++) {
                 SignalROI *roi = *it;
                 // Duplicate them
-                SignalROI *loose_roi = new SignalROI(roi);
+                SignalROI *loose_roi = roi_pool.make(roi);
 
                 rois_u_loose.at(i).push_back(loose_roi);
 
@@ -1043,7 +1032,7 @@ void ROI_refinement::generate_merge_ROIs(int plane)
             for (auto it = saved_rois.begin(); it != saved_rois.end(); it++) {
                 SignalROI *roi = *it;
                 // Duplicate them
-                SignalROI *loose_roi = new SignalROI(roi);
+                SignalROI *loose_roi = roi_pool.make(roi);
 
                 rois_v_loose.at(i).push_back(loose_roi);
 
@@ -1358,10 +1347,10 @@ void ROI_refinement::CleanUpCollectionROIs()
             }
             back_rois.erase(roi);
         }
-        auto it1 = find(rois_w_tight.at(chid).begin(), rois_w_tight.at(chid).end(), roi);
+        auto it1 = std::find(rois_w_tight.at(chid).begin(), rois_w_tight.at(chid).end(), roi);
         if (it1 != rois_w_tight.at(chid).end()) rois_w_tight.at(chid).erase(it1);
 
-        delete roi;
+        roi_pool.release(roi);
     }
 }
 
@@ -1391,7 +1380,7 @@ void ROI_refinement::CleanUpInductionROIs(int plane)
     //    for (auto it = Bad_ROIs.begin(); it!=Bad_ROIs.end(); it ++){
     //      SignalROI* roi = *it;
     //      int chid = roi->get_chid();
-    //      auto it1 = find(rois_u_loose.at(chid).begin(), rois_u_loose.at(chid).end(),roi);
+    //      auto it1 = std::find(rois_u_loose.at(chid).begin(), rois_u_loose.at(chid).end(),roi);
     //      if (it1 != rois_u_loose.at(chid).end())
     // rois_u_loose.at(chid).erase(it1);
 
@@ -1430,7 +1419,7 @@ void ROI_refinement::CleanUpInductionROIs(int plane)
     //    for (auto it = Bad_ROIs.begin(); it!=Bad_ROIs.end(); it ++){
     //      SignalROI* roi = *it;
     //      int chid = roi->get_chid()-nwire_u;
-    //      auto it1 = find(rois_v_loose.at(chid).begin(), rois_v_loose.at(chid).end(),roi);
+    //      auto it1 = std::find(rois_v_loose.at(chid).begin(), rois_v_loose.at(chid).end(),roi);
     //      if (it1 != rois_v_loose.at(chid).end())
     // rois_v_loose.at(chid).erase(it1);
 
@@ -1522,10 +1511,10 @@ void ROI_refinement::CleanUpInductionROIs(int plane)
                 }
                 back_rois.erase(roi);
             }
-            auto it1 = find(rois_u_loose.at(chid).begin(), rois_u_loose.at(chid).end(), roi);
+            auto it1 = std::find(rois_u_loose.at(chid).begin(), rois_u_loose.at(chid).end(), roi);
             if (it1 != rois_u_loose.at(chid).end()) rois_u_loose.at(chid).erase(it1);
 
-            delete roi;
+            roi_pool.release(roi);
         }
     }
     else if (plane == 1) {
@@ -1592,10 +1581,10 @@ void ROI_refinement::CleanUpInductionROIs(int plane)
                 }
                 back_rois.erase(roi);
             }
-            auto it1 = find(rois_v_loose.at(chid).begin(), rois_v_loose.at(chid).end(), roi);
+            auto it1 = std::find(rois_v_loose.at(chid).begin(), rois_v_loose.at(chid).end(), roi);
             if (it1 != rois_v_loose.at(chid).end()) rois_v_loose.at(chid).erase(it1);
 
-            delete roi;
+            roi_pool.release(roi);
         }
     }
 }
@@ -1764,7 +1753,7 @@ void ROI_refinement::ShrinkROI(SignalROI *roi, ROI_formation &roi_form)
 
     SignalROISelection new_rois;
     if (new_start_bin >= 0 && new_end_bin > new_start_bin) {
-        SignalROI *new_roi = new SignalROI(plane, chid, new_start_bin, new_end_bin, signal);
+        SignalROI *new_roi = roi_pool.make(plane, chid, new_start_bin, new_end_bin, signal);
         new_rois.push_back(new_roi);
     }
 
@@ -1835,7 +1824,7 @@ void ROI_refinement::ShrinkROI(SignalROI *roi, ROI_formation &roi_form)
     }
 
     // delete the old ROI
-    delete roi;
+    roi_pool.release(roi);
 
     // delete htemp;
     // delete h1;
@@ -2370,7 +2359,7 @@ void ROI_refinement::BreakROI1(SignalROI *roi)
             //      h1->SetBinContent(j+1,htemp->GetBinContent(j-start_bin+1));
         }
         if (start_bin1 >= 0 && end_bin1 > start_bin1) {
-            SignalROI *sub_roi = new SignalROI(plane, chid, start_bin1, end_bin1, signal);
+            SignalROI *sub_roi = roi_pool.make(plane, chid, start_bin1, end_bin1, signal);
             new_rois.push_back(sub_roi);
         }
     }
@@ -2440,7 +2429,7 @@ void ROI_refinement::BreakROI1(SignalROI *roi)
     }
 
     // delete the old ROI
-    delete roi;
+    roi_pool.release(roi);
     //  delete h1;
     //  delete htemp;
 }
@@ -2885,7 +2874,7 @@ void ROI_refinement::TestROIs()
             // loop through front
             for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
-                if (find(rois_u_loose.at(chid + 1).begin(), rois_u_loose.at(chid + 1).end(), roi1) ==
+                if (std::find(rois_u_loose.at(chid + 1).begin(), rois_u_loose.at(chid + 1).end(), roi1) ==
                     rois_u_loose.at(chid + 1).end())
                     std::cout << chid << " u " << +1 << " " << roi << " " << roi1 << std::endl;
             }
@@ -2893,7 +2882,7 @@ void ROI_refinement::TestROIs()
             // loop through back
             for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
-                if (find(rois_u_loose.at(chid - 1).begin(), rois_u_loose.at(chid - 1).end(), roi1) ==
+                if (std::find(rois_u_loose.at(chid - 1).begin(), rois_u_loose.at(chid - 1).end(), roi1) ==
                     rois_u_loose.at(chid - 1).end())
                     std::cout << chid << " u " << -1 << " " << roi << " " << roi1 << std::endl;
             }
@@ -2906,7 +2895,7 @@ void ROI_refinement::TestROIs()
             // loop through front
             for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
-                if (find(rois_v_loose.at(chid + 1).begin(), rois_v_loose.at(chid + 1).end(), roi1) ==
+                if (std::find(rois_v_loose.at(chid + 1).begin(), rois_v_loose.at(chid + 1).end(), roi1) ==
                     rois_v_loose.at(chid + 1).end())
                     std::cout << chid << " v " << +1 << " " << roi << " " << roi1 << std::endl;
             }
@@ -2914,7 +2903,7 @@ void ROI_refinement::TestROIs()
             // loop through back
             for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
-                if (find(rois_v_loose.at(chid - 1).begin(), rois_v_loose.at(chid - 1).end(), roi1) ==
+                if (std::find(rois_v_loose.at(chid - 1).begin(), rois_v_loose.at(chid - 1).end(), roi1) ==
                     rois_v_loose.at(chid - 1).end())
                     std::cout << chid << " v " << -1 << " " << roi << " " << roi1 << std::endl;
             }
@@ -2927,7 +2916,7 @@ void ROI_refinement::TestROIs()
             // loop through front
             for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
-                if (find(rois_w_tight.at(chid + 1).begin(), rois_w_tight.at(chid + 1).end(), roi1) ==
+                if (std::find(rois_w_tight.at(chid + 1).begin(), rois_w_tight.at(chid + 1).end(), roi1) ==
                     rois_w_tight.at(chid + 1).end())
                     std::cout << chid << " w " << +1 << " " << roi << " " << roi1 << std::endl;
             }
@@ -2935,7 +2924,7 @@ void ROI_refinement::TestROIs()
             // loop through back
             for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
-                if (find(rois_w_tight.at(chid - 1).begin(), rois_w_tight.at(chid - 1).end(), roi1) ==
+                if (std::find(rois_w_tight.at(chid - 1).begin(), rois_w_tight.at(chid - 1).end(), roi1) ==
                     rois_w_tight.at(chid - 1).end())
                     std::cout << chid << " w " << -1 << " " << roi << " " << roi1 << std::endl;
             }
@@ -110,6 +110,9 @@ namespace WireCell {
             SignalROIMap back_rois;
             SignalROIMap contained_rois;
 
+            // owns all ROIs above, made and released per frame
+            SignalROIPool roi_pool;
+
             Log::logptr_t log;
 
             bool isWrapped;
@@ -6,11 +6,17 @@ using namespace WireCell;
 using namespace WireCell::SigProc;
 
 SignalROI::SignalROI(int plane, int chid, int start_bin, int end_bin, const Waveform::realseq_t& signal)
-  : plane(plane)
-  , chid(chid)
-  , start_bin(start_bin)
-  , end_bin(end_bin)
 {
+    assign(plane, chid, start_bin, end_bin, signal);
+}
+
+void SignalROI::assign(int plane, int chid, int start_bin, int end_bin, const Waveform::realseq_t& signal)
+{
+    this->plane = plane;
+    this->chid = chid;
+    this->start_bin = start_bin;
+    this->end_bin = end_bin;
+
     float start_content = signal.at(start_bin);
     float end_content = signal.at(end_bin);
     contents.resize(end_bin - start_bin + 1);
@@ -125,3 +131,35 @@ std::vector<std::pair<int, int>> SignalROI::get_above_threshold(float th)
 
     return bins;
 }
+
+SignalROI* SignalROIPool::make(int plane, int chid, int start_bin, int end_bin, const Waveform::realseq_t& signal)
+{
+    if (m_free.empty()) {
+        m_rois.emplace_back(plane, chid, start_bin, end_bin, signal);
+        return &m_rois.back();
+    }
+    SignalROI* roi = m_free.back();
+    m_free.pop_back();
+    roi->assign(plane, chid, start_bin, end_bin, signal);
+    return roi;
+}
+
+SignalROI* SignalROIPool::make(SignalROI* other)
+{
+    if (m_free.empty()) {
+        m_rois.emplace_back(other);
+        return &m_rois.back();
+    }
+    SignalROI* roi = m_free.back();
+    m_free.pop_back();
+    *roi = *other;
+    return roi;
+}
+
+void SignalROIPool::release(SignalROI* roi) { m_free.push_back(roi); }
+
+void SignalROIPool::clear()
+{
+    m_free.clear();
+    m_rois.clear();
+}
@@ -3,10 +3,14 @@
 
 #include "WireCellUtil/Waveform.h"
 
+#include <boost/container/small_vector.hpp>
+
+#include <deque>
 #include <iostream>
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
 
 namespace WireCell {
     namespace SigProc {
@@ -15,6 +19,10 @@ namespace WireCell {
             SignalROI(int plane, int chid, int start_bin, int end_bin, const Waveform::realseq_t& signal);
             SignalROI(SignalROI* roi);
             ~SignalROI();
+
+            // Reset to what the first constructor would give while
+            // keeping the content storage.
+            void assign(int plane, int chid, int start_bin, int end_bin, const Waveform::realseq_t& signal);
             int get_start_bin() { return start_bin; }
             int get_end_bin() { return end_bin; }
 
@@ -47,10 +55,32 @@ namespace WireCell {
         };
 
         typedef std::list<SignalROI*> SignalROIList;
-        typedef std::vector<SignalROI*> SignalROISelection;
+        // Most selections, in particular the ROIs linked to one ROI,
+        // are short and are kept inline.
+        typedef boost::container::small_vector<SignalROI*, 4> SignalROISelection;
         typedef std::vector<SignalROISelection> SignalROIChSelection;
         typedef std::vector<SignalROIList> SignalROIChList;
-        typedef std::map<SignalROI*, SignalROISelection> SignalROIMap;
+        typedef std::unordered_map<SignalROI*, SignalROISelection> SignalROIMap;
+
+        // Own all SignalROIs made while processing one frame.  A
+        // released ROI is kept and its slot, including its content
+        // storage, is reused by the next one made.  Pointers stay
+        // valid until the ROI is released or the pool is cleared.
+        class SignalROIPool {
+           public:
+            SignalROI* make(int plane, int chid, int start_bin, int end_bin, const Waveform::realseq_t& signal);
+            // Make a copy of the ROI.
+            SignalROI* make(SignalROI* roi);
+            void release(SignalROI* roi);
+            void clear();
+
+            // Number of ROIs made and not released.
+            size_t size() const { return m_rois.size() - m_free.size(); }
+
+           private:
+            std::deque<SignalROI> m_rois;
+            std::vector<SignalROI*> m_free;
+        };
 
         struct CompareRois {
             bool operator()(SignalROI* roi1, SignalROI* roi2) const
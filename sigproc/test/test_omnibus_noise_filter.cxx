@@ -0,0 +1,146 @@
+// Check SigProc::OmnibusNoiseFilter gives the same frame and masks
+// when channels and groups are filtered over several threads and when
+// a group lists a channel twice.
+#include "WireCellSigProc/OmnibusNoiseFilter.h"
+#include "WireCellSigProc/SimpleChannelNoiseDB.h"
+
+#include "WireCellAux/SimpleFrame.h"
+#include "WireCellAux/SimpleTrace.h"
+#include "WireCellUtil/PluginManager.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Testing.h"
+
+#include <map>
+
+using namespace WireCell;
+using namespace WireCell::SigProc;
+
+// Remove the median of each channel and mask any ticks far above it.
+struct ToyOneChannel : public IChannelFilter {
+    virtual Waveform::ChannelMaskMap apply(int channel, signal_t& sig) const
+    {
+        Waveform::ChannelMaskMap ret;
+        const float median = Waveform::median(sig);
+        for (size_t ind = 0; ind < sig.size(); ++ind) {
+            sig[ind] -= median;
+            if (sig[ind] > 40) {
+                ret["noisy"][channel].push_back(Waveform::BinRange(ind, ind + 1));
+            }
+        }
+        return ret;
+    }
+    virtual Waveform::ChannelMaskMap apply(channel_signals_t& chansig) const { return {}; }
+};
+
+// Remove the average over the group and mark the group's first channel.
+struct ToyCoherent : public IChannelFilter {
+    virtual Waveform::ChannelMaskMap apply(int channel, signal_t& sig) const { return {}; }
+    virtual Waveform::ChannelMaskMap apply(channel_signals_t& chansig) const
+    {
+        Waveform::ChannelMaskMap ret;
+        signal_t avg(chansig.begin()->second.size(), 0);
+        for (const auto& cs : chansig) {
+            Waveform::increase(avg, cs.second);
+        }
+        Waveform::scale(avg, 1.0 / chansig.size());
+        for (auto& cs : chansig) {
+            for (size_t ind = 0; ind < avg.size(); ++ind) {
+                cs.second[ind] -= avg[ind];
+            }
+        }
+        ret["lf_noisy"][chansig.begin()->first].push_back(Waveform::BinRange(0, 10));
+        return ret;
+    }
+};
+
+static IFrame::pointer run(const IFrame::pointer& in, int nthreads, bool repeat = false)
+{
+    const std::string noisedb_tn = "testChannelNoiseDB:" + std::to_string(nthreads) + (repeat ? "r" : "");
+    auto noisedb = std::dynamic_pointer_cast<SimpleChannelNoiseDB>(
+        Factory::lookup_tn<IChannelNoiseDatabase>(noisedb_tn));
+    noisedb->configure(noisedb->default_configuration());
+    std::vector<std::vector<int>> groups;
+    for (int first = 0; first < 48; first += 8) {  // last group has unknown channels
+        std::vector<int> group;
+        for (int ch = first; ch < first + 8; ++ch) {
+            group.push_back(ch);
+        }
+        if (repeat) {
+            group.push_back(first + 2);
+        }
+        groups.push_back(group);
+    }
+    noisedb->set_channel_groups(groups);
+    noisedb->set_bad_channels({3, 17});
+
+    OmnibusNoiseFilter bus;
+    auto cfg = bus.default_configuration();
+    cfg["nticks"] = 100;
+    cfg["nthreads"] = nthreads;
+    cfg["channel_filters"] = Json::arrayValue;
+    cfg["channel_status_filters"] = Json::arrayValue;
+    cfg["grouped_filters"] = Json::arrayValue;
+    cfg["noisedb"] = noisedb_tn;
+    bus.configure(cfg);
+    bus.set_channel_filters({std::make_shared<ToyOneChannel>()});
+    bus.set_grouped_filters({std::make_shared<ToyCoherent>()});
+    bus.set_channel_status_filters({std::make_shared<ToyOneChannel>()});
+
+    IFrame::pointer out;
+    Assert(bus(in, out));
+    Assert(out);
+    return out;
+}
+
+int main()
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellAux");
+    pm.add("WireCellSigProc");
+    Factory::lookup_tn<IDFT>("FftwDFT");
+
+    // Channels in reverse order, some short or long, one repeated.
+    ITrace::vector traces;
+    for (int ch = 39; ch >= 0; --ch) {
+        const size_t nticks = ch % 7 == 0 ? 90 : (ch % 11 == 0 ? 110 : 100);
+        ITrace::ChargeSequence charge(nticks);
+        for (size_t ind = 0; ind < nticks; ++ind) {
+            charge[ind] = (ch * 31 + ind * 17) % 101 + (ind % 8 == ch % 8 ? 50 : 0);
+        }
+        traces.push_back(std::make_shared<Aux::SimpleTrace>(ch, 0, charge));
+    }
+    traces.push_back(std::make_shared<Aux::SimpleTrace>(5, 0, ITrace::ChargeSequence(100, 1.0)));
+    auto in = std::make_shared<Aux::SimpleFrame>(1, 0, traces, 0.5 * units::us);
+    IFrame::trace_list_t all(traces.size());
+    for (size_t ind = 0; ind < all.size(); ++ind) {
+        all[ind] = ind;
+    }
+    in->tag_traces("orig", all);
+
+    auto serial = run(in, 1);
+    auto threaded = run(in, 4);
+
+    auto bychan = [](const IFrame::pointer& frame) {
+        std::map<int, ITrace::ChargeSequence> ret;
+        for (const auto& trace : *frame->traces()) {
+            Assert(trace->charge().size() == 100);
+            Assert(ret.find(trace->channel()) == ret.end());
+            ret[trace->channel()] = trace->charge();
+        }
+        return ret;
+    };
+    auto s = bychan(serial);
+    auto t = bychan(threaded);
+    Assert(s.size() == 40);
+    Assert(s == t);
+    auto repeated = run(in, 4, true);
+    Assert(bychan(repeated) == s);
+    Assert(repeated->masks() == serial->masks());
+
+    auto smasks = serial->masks();
+    Assert(smasks == threaded->masks());
+    Assert(smasks["bad"].size() > 2);  // "noisy" maps to "bad"
+    Assert(smasks["bad"].find(17) != smasks["bad"].end());
+    Assert(smasks["lf_noisy"].size() == 5);
+    return 0;
+}
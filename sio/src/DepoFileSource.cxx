@@ -6,8 +6,7 @@
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
 
-#include "WireCellAux/SimpleDepo.h"
-#include "WireCellAux/SimpleDepoSet.h"
+#include "WireCellAux/ColumnarDepoSet.h"
 
 #include "WireCellAux/DepoTools.h"
 
@@ -181,66 +180,58 @@ IDepoSet::pointer Sio::DepoFileSource::next()
         return nullptr;
     }
         
-    // build list of depos in order given
-    std::vector<std::shared_ptr<Aux::SimpleDepo>> all_sdepos;
-
-    // First pass make all depos
+    // Fill columns directly, with no per depo objects.
+    DepoColumns cols;
+    for (auto* col : {&cols.time, &cols.charge, &cols.energy, &cols.x, &cols.y, &cols.z,
+                      &cols.extent_long, &cols.extent_tran}) {
+        col->resize(ndepos);
+    }
+    cols.id.resize(ndepos);
+    cols.pdg.resize(ndepos);
+    cols.prior.resize(ndepos, -1);
     for (size_t ind=0; ind < ndepos; ++ind) {
-
-        auto sdepo = std::make_shared<Aux::SimpleDepo>(
-            darr(ind, 0),        // t
-            Point(darr(ind, 2),  // x
-                  darr(ind, 3),  // y
-                  darr(ind, 4)), // z
-            darr(ind, 1)*m_scale,// q
-            nullptr,             // prior
-            darr(ind, 5),        // extent_long
-            darr(ind, 6),        // extent_tran
-            iarr(ind, 0),        // id
-            iarr(ind, 1));       // pdg
-
-        all_sdepos.push_back(sdepo);
-    }
-
-    // second pass, save out the active and resolve the prior depos
-    std::vector<std::shared_ptr<Aux::SimpleDepo>> sdepos;
+        cols.time[ind] = darr(ind, 0);
+        cols.charge[ind] = darr(ind, 1)*m_scale;
+        cols.energy[ind] = 1.0; // not stored
+        cols.x[ind] = darr(ind, 2);
+        cols.y[ind] = darr(ind, 3);
+        cols.z[ind] = darr(ind, 4);
+        cols.extent_long[ind] = darr(ind, 5);
+        cols.extent_tran[ind] = darr(ind, 6);
+        cols.id[ind] = iarr(ind, 0);
+        cols.pdg[ind] = iarr(ind, 1);
+    }
+
+    // Save out the active and resolve the prior depos
     size_t npriors = 0;
     size_t npriors_missing = 0;
     for (size_t ind=0; ind < ndepos; ++ind) {
 
         const auto gen = iarr(ind, 2);
         if (!gen) {  // active
-            sdepos.push_back(all_sdepos[ind]);
+            cols.active.push_back(ind);
             continue;
         }
 
         // Prior
         const size_t other = iarr(ind, 3);
-        if (other >= all_sdepos.size()) {
+        if (other >= ndepos) {
             ++npriors_missing;
         }
         else {
             ++npriors;
-            all_sdepos[other]->set_prior(all_sdepos[ind]);
+            cols.prior[other] = ind;
         }
     }
     if (npriors_missing) {
         log->warn("call={}, missing {} prior depos, active={} total={}",
-                  m_count, npriors_missing, sdepos.size(), all_sdepos.size());
-    }
-    all_sdepos.clear();
-
-    // convert to IDepos
-    WireCell::IDepo::vector idepos;
-    for (auto sdepo: sdepos) {
-        idepos.push_back(sdepo);
+                  m_count, npriors_missing, cols.active.size(), ndepos);
     }
-    sdepos.clear();
 
     log->debug("call={} loaded {} active, {} total depos from ident {} stream {} with {} priors",
-               m_count, idepos.size(), ndepos, ident, m_inname, npriors);
+               m_count, cols.active.size(), ndepos, ident, m_inname, npriors);
 
-    return std::make_shared<Aux::SimpleDepoSet>(ident, idepos);
+    return std::make_shared<Aux::ColumnarDepoSet>(ident, std::move(cols));
 }
 
 bool Sio::DepoFileSource::operator()(IDepoSet::pointer& ds)
@@ -3,19 +3,50 @@
 
 #include "WireCellIface/IDataFlowGraph.h"
 #include "WireCellIface/IConfigurable.h"
+#include "WireCellIface/ITerminal.h"
 #include "WireCellAux/Logger.h"
 #include "WireCellTbb/NodeWrapper.h"
 #include "WireCellTbb/WrapperFactory.h"
 
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace WireCellTbb {
 
+    /** A data flow graph executed by TBB.
+
+        Configuration parameters:
+
+        - max_threads :: limit the number of threads, 0 for no limit.
+
+        - summary :: log per-node run time summary at 1=debug,
+          2=info or 0 to not log.
+
+        - edge_capacity :: if nonzero, the number of messages which
+          may be queued on each edge and not yet consumed by a call
+          of the node at its head.  A full edge holds back the tail
+          node's output which in turn throttles sources.
+
+        - max_in_flight :: if nonzero, the number of messages each
+          source node may emit beyond the number of calls completed
+          by all sink nodes.  This assumes each message from a
+          source leads to a sink call.  Graphs with nodes that
+          aggregate many input messages into one output may deadlock
+          if this is less than the aggregate size.
+
+        - profile :: if set, name a file to receive a Chrome /
+          Perfetto trace event JSON of all node calls when finalized.
+
+        - profile_memory :: if true, also sample resident memory
+          after each node call.
+     */
     class DataFlowGraph : public WireCell::Aux::Logger,
                           public WireCell::IDataFlowGraph,
-                          public WireCell::IConfigurable
+                          public WireCell::IConfigurable,
+                          public WireCell::ITerminal
     {
       public:
         DataFlowGraph(int max_threads = 0);
@@ -32,7 +63,30 @@ namespace WireCellTbb {
         virtual void configure(const WireCell::Configuration& config);
         virtual WireCell::Configuration default_configuration() const;
 
+        /// Write the profile, if configured.
+        virtual void finalize();
+
       private:
+        // Make the TBB edges of the connections, with limiters if so
+        // configured, and attach nodes to the profile, if any.
+        void make_edges();
+
+        struct Connection {
+            sender_type* sender;
+            receiver_type* receiver;
+            WireCellTbb::Node tail, head;
+        };
+        std::vector<Connection> m_connections;
+        bool m_connected{false};
+
+        int m_edge_capacity{0};  // 0 means unbounded
+        int m_max_in_flight{0};  // 0 means unbounded
+        std::vector<std::unique_ptr<limiter_node>> m_limiters;
+        std::unique_ptr<done_node> m_sinks_done;
+
+        std::string m_profile_file{""};
+        std::unique_ptr<WireCell::NodeProfile> m_profile;
+
         tbb::flow::graph m_graph;    // here lives the TBB graph
         WrapperFactory m_factory;
 
@@ -10,14 +10,13 @@
 
 namespace WireCellTbb {
 
-    // Body for a TBB join node.
+    // Body for a TBB join node.  Each input tuple holds messages of
+    // the same seqno which is given to the output.
     template <typename TupleType>
     class FaninBody {
         WireCell::IFaninNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        mutable seqno_t m_seqno{0};
-
       public:
         typedef typename WireCell::IFaninNodeBase::any_vector any_vector;
         typedef typename WireCell::tuple_helper<TupleType> helper_type;
@@ -37,13 +36,13 @@ namespace WireCellTbb {
                 in.push_back(msg.second);
             }
             wct_t out;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in, out);
-            m_info.stop();
+            m_info.stop(t0, in.size(), 1);
             if (!ok) {
                 std::cerr << "TbbFlow: fanin node return false ignored\n";
             }
-            return msg_t(m_seqno++, out);
+            return msg_t(std::get<0>(tup).first, out);
         }
     };
 
@@ -61,7 +60,7 @@ namespace WireCellTbb {
 
         // this node takes user WC body and runs it after converting input tuple to vector
         typedef tbb::flow::function_node<TupleType, msg_t> joining_node;
-        joining_node* fn = new joining_node(graph, 1 /*wcnode->concurrency()*/,
+        joining_node* fn = new joining_node(graph, wcnode->concurrency(),
                                             FaninBody<TupleType>(wcnode, info));
 
         tbb::flow::make_edge(*jn, *fn);
@@ -10,19 +10,14 @@
 
 namespace WireCellTbb {
 
-    // Body for a TBB split node.
+    // Body for a TBB split node.  All outputs carry the seqno of
+    // the input so the sequencers on each output port restore order
+    // when calls run concurrently.
     template <typename std::size_t N>
     class FanoutBody {
         WireCell::IFanoutNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        // This is maybe better provided as a std::atomic.  However,
-        // the lack of copy constructor conflicts with the need for
-        // the body to be copied.  For now, we are safe as we ignore
-        // wcnode's desired concurrency and force the parent
-        // function_node to have concurrency=1.
-        mutable size_t m_seqno{0};
-
       public:
         typedef typename WireCell::IFanoutNodeBase::any_vector any_vector;
         typedef typename WireCell::type_repeater<N, msg_t>::type TupleType;
@@ -37,14 +32,14 @@ namespace WireCellTbb {
         TupleType operator()(msg_t in) const
         {
             any_vector anyvec;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in.second, anyvec);
-            m_info.stop();
+            m_info.stop(t0, 1, anyvec.size());
             if (!ok ) {
                 std::cerr << "TbbFlow: fanout call fails\n";
             }
             msg_vector_t savec;
-            const size_t seqno = m_seqno++;
+            const seqno_t seqno = in.first;
             for (auto& a : anyvec) {
                 savec.push_back(msg_t(seqno, a));
             }
@@ -64,8 +59,7 @@ namespace WireCellTbb {
         using tuple_func_node = tbb::flow::function_node<msg_t, TupleType>;
 
         // This node takes user WC body and runs it after converting input verctor to tuple.
-        // We force-set concurency=1 so as not to upset to seqno in the body.
-        auto* fn = new tuple_func_node(graph, 1 /*wcnode->concurrency()*/,
+        auto* fn = new tuple_func_node(graph, wcnode->concurrency(),
                                        FanoutBody<N>(wcnode, info));
         // Below requires first to be the WCT body caller
         nodes.push_back(fn);
@@ -8,13 +8,13 @@
 
 namespace WireCellTbb {
 
-    // Body for a TBB function node.
+    // Body for a TBB function node.  The output carries the seqno
+    // of its input so that calls that run concurrently may be put
+    // back in order by the sequencer that follows.
     class FunctionBody {
         WireCell::IFunctionNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        mutable seqno_t m_seqno{0};
-
       public:
         FunctionBody(WireCell::INode::pointer wcnode, NodeInfo& info)
             : m_wcnode(std::dynamic_pointer_cast<WireCell::IFunctionNodeBase>(wcnode))
@@ -26,13 +26,13 @@ namespace WireCellTbb {
         msg_t operator()(const msg_t& in) const
         {
             wct_t out;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in.second, out);
-            m_info.stop();
+            m_info.stop(t0);
             if (!ok) {
                 std::cerr << "TbbFlow: function node return false ignored\n";
             }
-            return msg_t(m_seqno++, out);
+            return msg_t(in.first, out);
         }
     };
 
@@ -45,7 +45,7 @@ namespace WireCellTbb {
         FunctionWrapper(tbb::flow::graph& graph, WireCell::INode::pointer wcnode)
         {
             m_info.set(wcnode);
-            auto fn = new func_node(graph, 1 /*wcnode->concurrency()*/, FunctionBody(wcnode, m_info));
+            auto fn = new func_node(graph, wcnode->concurrency(), FunctionBody(wcnode, m_info));
             auto sn = new seq_node(graph, [](const msg_t& m) {return m.first;});
             tbb::flow::make_edge(*fn, *sn);
             m_fn = fn;
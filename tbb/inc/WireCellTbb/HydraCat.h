@@ -158,9 +158,13 @@ namespace WireCellTbb {
             size_t index = in.first;
             iqv[index].push_back(in.second.second);
 
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(iqv, oqv);
-            m_info.stop();
+            size_t nout = 0;
+            for (const auto& oq : oqv) {
+                nout += oq.size();
+            }
+            m_info.stop(t0, 1, nout);
             if (!ok) {
                 std::cerr << "TbbFlow: hydra body return false ignored\n";
             }
@@ -4,6 +4,7 @@
 #include "WireCellIface/INode.h"
 #include "WireCellIface/INamed.h"
 #include "WireCellUtil/TupleHelpers.h"
+#include "WireCellUtil/NodeProfile.h"
 
 #include <tbb/flow_graph.h>
 #include <boost/any.hpp>
@@ -11,8 +12,10 @@
 #include <utility>              // make_index_sequence
 #include <string>
 #include <memory>
+#include <atomic>
 #include <chrono>
 #include <map>
+#include <mutex>
 
 namespace WireCellTbb {
 
@@ -39,12 +42,46 @@ namespace WireCellTbb {
     using mfunc_node = tbb::flow::multifunction_node<msg_t, std::tuple<msg_t>>;
     using seq_node = tbb::flow::sequencer_node<msg_t>;
     using sink_node = tbb::flow::function_node<msg_t>;
+    using limiter_node = tbb::flow::limiter_node<msg_t>;
+
+    // Receives a message each time a WCT node completes a call.
+    using done_node = tbb::flow::broadcast_node<tbb::flow::continue_msg>;
 
     // tuple type nodes include join_node, split_node and indexer_node
 
-    // A helper to provide info about the node.
+    // A helper to provide info about the node.  The stop watch may
+    // be used by concurrent executions of the node.
     class NodeInfo {
       public:
+        using clock_t = WireCell::NodeProfile::clock_t;
+        using time_point_t = clock_t::time_point;
+        using duration_t = std::chrono::duration<double>;
+
+        // Mark the start of one execution.
+        struct Start {
+            time_point_t time;
+            // Number of executions in progress, including this one.
+            size_t active;
+        };
+
+        NodeInfo() = default;
+        // The mutex and atomic counter rule out the defaults.
+        NodeInfo(const NodeInfo& other) { *this = other; }
+        NodeInfo& operator=(const NodeInfo& other) {
+            if (this == &other) {
+                return *this;
+            }
+            std::lock_guard<std::mutex> lock(other.m_mutex);
+            m_inode = other.m_inode;
+            m_runtime = other.m_runtime;
+            m_maxrt = other.m_maxrt;
+            m_calls = other.m_calls;
+            m_done = other.m_done;
+            m_active = other.m_active.load();
+            m_profile = other.m_profile;
+            m_profile_index = other.m_profile_index;
+            return *this;
+        }
 
         void set(WireCell::INode::pointer wcnode) { m_inode = wcnode; }
 
@@ -60,21 +97,46 @@ namespace WireCellTbb {
             return "(unknown)";
         }
 
-        // Start/stop the stop watch.
-        void start() {
-            m_clock = std::chrono::high_resolution_clock::now();
+        // Start the stop watch for one execution.
+        Start start() {
+            return Start{clock_t::now(), ++m_active};
         }
-        void stop() {
-            duration_t delta = std::chrono::high_resolution_clock::now() - m_clock;
-            m_runtime += delta;
-            if (delta > m_maxrt) {
-                m_maxrt = delta;
+        // Stop the stop watch for the execution with the given start
+        // which consumed nin and produced nout objects.  This also
+        // signals the completion and records to the profile, if so
+        // requested.
+        void stop(const Start& start, size_t nin = 1, size_t nout = 1) {
+            const auto now = clock_t::now();
+            --m_active;
+            duration_t delta = now - start.time;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_runtime += delta;
+                if (delta > m_maxrt) {
+                    m_maxrt = delta;
+                }
+                ++m_calls;
+            }
+            if (m_profile) {
+                // TBB does not expose the depth of the input buffer
+                // of its nodes so the executions in progress are
+                // given instead.
+                m_profile->record(m_profile_index, start.time, now, start.active, nin, nout);
+            }
+            if (m_done) {
+                m_done->try_put(tbb::flow::continue_msg());
             }
-            ++m_calls;
         }
 
-        //using duration_t = std::chrono::high_resolution_clock::duration;
-        using duration_t = std::chrono::duration<double>;
+        // Send a message to node on each completed execution.
+        void notify(done_node* node) { m_done = node; }
+
+        // Record each execution to the profile as the given node.
+        void profile(WireCell::NodeProfile* prof, size_t index)
+        {
+            m_profile = prof;
+            m_profile_index = index;
+        }
 
         // Total runtime for all executions.
         duration_t runtime() const {
@@ -92,11 +154,12 @@ namespace WireCellTbb {
       private:
         WireCell::INode::pointer m_inode;
         duration_t m_runtime {0}, m_maxrt{0};
-        using clock_t = std::chrono::high_resolution_clock;
-        using time_point_t = clock_t::time_point;
-        time_point_t m_clock;
-
         size_t m_calls{0};
+        mutable std::mutex m_mutex;
+        done_node* m_done{nullptr};
+        std::atomic<size_t> m_active{0};
+        WireCell::NodeProfile* m_profile{nullptr};
+        size_t m_profile_index{0};
     };
     std::ostream& operator<<(std::ostream& os, const NodeInfo& info);
 
@@ -114,8 +177,27 @@ namespace WireCellTbb {
         virtual void initialize() {}
 
         const NodeInfo& info() const { return m_info; };
+
+        // Record each execution of the wrapped WCT node to the profile.
+        void profile(WireCell::NodeProfile& prof, const std::string& name)
+        {
+            m_info.profile(&prof, prof.add_node(name));
+        }
+
+        // Return a node which receives a message each time the
+        // wrapped WCT node completes a call.
+        done_node& completions(tbb::flow::graph& graph)
+        {
+            if (!m_done) {
+                m_done = std::make_unique<done_node>(graph);
+                m_info.notify(m_done.get());
+            }
+            return *m_done;
+        }
+
       protected:
         NodeInfo m_info;
+        std::unique_ptr<done_node> m_done;
     };
 
     // expose the wrappers only as a shared pointer
@@ -24,9 +24,9 @@ namespace WireCellTbb {
         }
         tbb::flow::continue_msg operator()(const msg_t& in)
         {
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in.second);
-            m_info.stop();
+            m_info.stop(t0, 1, 0);
             if (!ok) {
                 std::cerr << "TbbFlow: sink node return false ignored\n";
             }
@@ -40,7 +40,7 @@ namespace WireCellTbb {
 
       public:
         SinkNodeWrapper(tbb::flow::graph& graph, WireCell::INode::pointer wcnode)
-            : m_tbbnode(new sink_node(graph, 1 /*wcnode->concurrency()*/, SinkBody(wcnode, m_info)))
+            : m_tbbnode(new sink_node(graph, wcnode->concurrency(), SinkBody(wcnode, m_info)))
         {
             m_info.set(wcnode);
         }
@@ -24,9 +24,9 @@ namespace WireCellTbb {
         }
         msg_t operator()(tbb::flow_control& fc) {
             wct_t out;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(out);
-            m_info.stop();
+            m_info.stop(t0, 0, ok ? 1 : 0);
             if (ok) {
                 return msg_t(m_seqno++, out);
             }
@@ -7,7 +7,8 @@
 
 #include <iostream>
 
-WIRECELL_FACTORY(TbbDataFlowGraph, WireCellTbb::DataFlowGraph, WireCell::IDataFlowGraph, WireCell::IConfigurable)
+WIRECELL_FACTORY(TbbDataFlowGraph, WireCellTbb::DataFlowGraph,
+                 WireCell::IDataFlowGraph, WireCell::IConfigurable, WireCell::ITerminal)
 
 using namespace std;
 using namespace WireCell;
@@ -27,6 +28,10 @@ Configuration DataFlowGraph::default_configuration() const
     Configuration cfg;
     cfg["max_threads"] = 0;
     cfg["summary"] = m_summary;
+    cfg["edge_capacity"] = m_edge_capacity;
+    cfg["max_in_flight"] = m_max_in_flight;
+    cfg["profile"] = m_profile_file;
+    cfg["profile_memory"] = false;
     return cfg;
 }
 
@@ -36,6 +41,27 @@ void DataFlowGraph::configure(const Configuration& cfg)
         m_thread_limit = cfg["max_threads"].asInt();
     }
     m_summary = get(cfg, "summary", m_summary);
+    m_edge_capacity = get(cfg, "edge_capacity", m_edge_capacity);
+    m_max_in_flight = get(cfg, "max_in_flight", m_max_in_flight);
+    if (m_edge_capacity < 0 || m_max_in_flight < 0) {
+        raise<ValueError>("edge_capacity and max_in_flight must not be negative");
+    }
+    m_profile_file = get(cfg, "profile", m_profile_file);
+    if (m_profile_file.empty()) {
+        m_profile.reset();
+    }
+    else {
+        m_profile = std::make_unique<NodeProfile>(get(cfg, "profile_memory", false));
+    }
+}
+
+void DataFlowGraph::finalize()
+{
+    if (!m_profile) {
+        return;
+    }
+    log->debug("writing profile of {} node calls to {}", m_profile->calls().size(), m_profile_file);
+    m_profile->dump(m_profile_file);
 }
 
 bool DataFlowGraph::connect(INode::pointer tail, INode::pointer head, size_t sport, size_t rport)
@@ -101,14 +127,71 @@ bool DataFlowGraph::connect(INode::pointer tail, INode::pointer head, size_t spo
         return false;
     }
 
-    make_edge(*s, *r);
+    // TBB edges are made at run() time when configuration is final.
+    m_connections.push_back({s, r, mytail, myhead});
     m_nodes.insert(mytail);
     m_nodes.insert(myhead);
     return true;
 }
 
+void DataFlowGraph::make_edges()
+{
+    if (m_connected) {
+        return;
+    }
+    m_connected = true;
+
+    if (m_profile) {
+        for (auto node : m_nodes) {
+            auto inode = node->info().inode();
+            std::string name = demangle(inode->signature());
+            auto inamed = std::dynamic_pointer_cast<INamed>(inode);
+            if (inamed and !inamed->get_name().empty()) {
+                name += ":" + inamed->get_name();
+            }
+            node->profile(*m_profile, name);
+        }
+    }
+
+    if (m_max_in_flight) {
+        // Funnel all sink completions so each decrements by one.
+        m_sinks_done = std::make_unique<done_node>(m_graph);
+        for (auto node : m_nodes) {
+            if (node->info().inode()->category() == INode::sinkNode) {
+                make_edge(node->completions(m_graph), *m_sinks_done);
+            }
+        }
+    }
+
+    for (auto& conn : m_connections) {
+        sender_type* s = conn.sender;
+
+        // Every sender is a buffering node (input_node or
+        // sequencer_node) so a message rejected by a full limiter
+        // is held and later pulled, not dropped.
+        if (m_max_in_flight && conn.tail->info().inode()->category() == INode::sourceNode) {
+            auto lim = std::make_unique<limiter_node>(m_graph, m_max_in_flight);
+            make_edge(*m_sinks_done, lim->decrementer());
+            make_edge(*s, *lim);
+            s = lim.get();
+            m_limiters.push_back(std::move(lim));
+        }
+        if (m_edge_capacity) {
+            auto lim = std::make_unique<limiter_node>(m_graph, m_edge_capacity);
+            make_edge(conn.head->completions(m_graph), lim->decrementer());
+            make_edge(*s, *lim);
+            s = lim.get();
+            m_limiters.push_back(std::move(lim));
+        }
+        make_edge(*s, *conn.receiver);
+    }
+    log->debug("made {} edges with {} limiters", m_connections.size(), m_limiters.size());
+}
+
 bool DataFlowGraph::run()
 {
+    make_edges();
+
     for (auto it : m_factory.seen()) {
         //log->debug("Initialize node of type: {}", demangle(it.first->signature()));
         it.second->initialize();
@@ -0,0 +1,150 @@
+/** Stress the TbbDataFlowGraph with a fast source of large payloads
+    feeding a slow function and report the peak resident memory with
+    and without bounded edges.
+
+    Usage: check_tbb_backpressure [nobjects [megabytes [sleep_ms]]]
+ */
+
+#include "WireCellTbb/DataFlowGraph.h"
+
+#include "WireCellIface/ISourceNode.h"
+#include "WireCellIface/IFunctionNode.h"
+#include "WireCellIface/ISinkNode.h"
+
+#include "WireCellUtil/MemUsage.h"
+#include "WireCellUtil/Testing.h"
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+
+struct Blob {
+    std::vector<double> data;
+};
+
+class BlobSource : public ISourceNode<Blob> {
+    int m_count{0}, m_nobjects;
+    size_t m_size;
+
+   public:
+    BlobSource(int nobjects, size_t size)
+      : m_nobjects(nobjects)
+      , m_size(size)
+    {
+    }
+    virtual ~BlobSource() {}
+    virtual std::string signature() { return typeid(BlobSource).name(); }
+    virtual bool operator()(output_pointer& out)
+    {
+        if (m_count > m_nobjects) {
+            return false;
+        }
+        if (m_count == m_nobjects) {
+            out = nullptr;
+        }
+        else {
+            auto blob = std::make_shared<Blob>();
+            blob->data.resize(m_size, m_count);  // touch the pages
+            out = blob;
+        }
+        ++m_count;
+        return true;
+    }
+};
+
+class SlowShrink : public IFunctionNode<Blob, Blob> {
+    int m_sleep_ms;
+
+   public:
+    SlowShrink(int sleep_ms)
+      : m_sleep_ms(sleep_ms)
+    {
+    }
+    virtual ~SlowShrink() {}
+    virtual std::string signature() { return typeid(SlowShrink).name(); }
+    virtual bool operator()(const input_pointer& in, output_pointer& out)
+    {
+        if (!in) {
+            out = nullptr;
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_sleep_ms));
+        auto blob = std::make_shared<Blob>();
+        blob->data.push_back(in->data.front());
+        out = blob;
+        return true;
+    }
+};
+
+class PeakSink : public ISinkNode<Blob> {
+   public:
+    double peak{0};
+    int count{0};
+    virtual ~PeakSink() {}
+    virtual std::string signature() { return typeid(PeakSink).name(); }
+    virtual bool operator()(const input_pointer& in)
+    {
+        peak = std::max(peak, memusage_resident());
+        if (in) {
+            ++count;
+        }
+        return true;
+    }
+};
+
+static double run(int nobjects, size_t size, int sleep_ms, int edge_capacity, int max_in_flight)
+{
+    auto src = std::make_shared<BlobSource>(nobjects, size);
+    auto fun = std::make_shared<SlowShrink>(sleep_ms);
+    auto sink = std::make_shared<PeakSink>();
+
+    WireCellTbb::DataFlowGraph dfg;
+    auto cfg = dfg.default_configuration();
+    cfg["edge_capacity"] = edge_capacity;
+    cfg["max_in_flight"] = max_in_flight;
+    cfg["summary"] = 0;
+    dfg.configure(cfg);
+
+    Assert(dfg.connect(src, fun));
+    Assert(dfg.connect(fun, sink));
+    const double before = memusage_resident();
+    Assert(dfg.run());
+    Assert(sink->count == nobjects);
+
+    std::cerr << "edge_capacity=" << edge_capacity << " max_in_flight=" << max_in_flight
+              << ": peak RSS " << sink->peak << " (start " << before << ")\n";
+    return sink->peak;
+}
+
+int main(int argc, char* argv[])
+{
+    int nobjects = 50;
+    int megabytes = 16;
+    int sleep_ms = 20;
+    if (argc > 1) nobjects = atoi(argv[1]);
+    if (argc > 2) megabytes = atoi(argv[2]);
+    if (argc > 3) sleep_ms = atoi(argv[3]);
+    const size_t size = megabytes * (1 << 20) / sizeof(double);
+
+    // Use an explicit arena so the source may run ahead of the slow
+    // function even on hosts with few cores.
+    const int nthreads = 4;
+    tbb::global_control gc(tbb::global_control::max_allowed_parallelism, nthreads);
+    tbb::task_arena arena(nthreads);
+
+    // Bounded first as RSS rarely shrinks back after the unbounded run.
+    double bounded = 0, unbounded = 0;
+    arena.execute([&]() {
+        bounded = run(nobjects, size, sleep_ms, 2, 4);
+        unbounded = run(nobjects, size, sleep_ms, 0, 0);
+    });
+    std::cerr << "peak RSS bounded/unbounded: " << bounded / unbounded << "\n";
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Check that TBB node wrappers honor INode::concurrency() while
+// preserving the order of data downstream.
+
+#include "WireCellTbb/NodeWrapper.h"
+#include "WireCellTbb/SourceCat.h"
+#include "WireCellTbb/FunctionCat.h"
+#include "WireCellTbb/FanoutCat.h"
+#include "WireCellTbb/JoinCat.h"
+#include "WireCellTbb/SinkCat.h"
+
+#include "WireCellIface/ISourceNode.h"
+#include "WireCellIface/IFunctionNode.h"
+#include "WireCellIface/IFanoutNode.h"
+#include "WireCellIface/IJoinNode.h"
+#include "WireCellIface/ISinkNode.h"
+
+#include "WireCellUtil/Testing.h"
+
+#include <tbb/flow_graph.h>
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+using namespace WireCellTbb;
+
+const int nobjects = 100;
+
+class CountSource : public ISourceNode<int> {
+    int m_count{0};
+
+   public:
+    virtual ~CountSource() {}
+    virtual bool operator()(output_pointer& out)
+    {
+        if (m_count > nobjects) {
+            return false;
+        }
+        if (m_count == nobjects) {
+            out = nullptr;  // EOS
+        }
+        else {
+            out = std::make_shared<int>(m_count);
+        }
+        ++m_count;
+        return true;
+    }
+};
+
+// A stateless, slow function that allows concurrent calls.
+class SlowFunction : public IFunctionNode<int, int> {
+    int m_conc;
+
+   public:
+    std::atomic<int> nactive{0}, maxactive{0};
+
+    SlowFunction(int conc)
+      : m_conc(conc)
+    {
+    }
+    virtual ~SlowFunction() {}
+    virtual int concurrency() { return m_conc; }
+    virtual bool operator()(const input_pointer& in, output_pointer& out)
+    {
+        if (!in) {
+            out = nullptr;
+            return true;
+        }
+        int now = ++nactive;
+        int prev = maxactive;
+        while (now > prev and !maxactive.compare_exchange_weak(prev, now)) {
+        }
+        // Vary the sleep so calls finish out of order.
+        std::this_thread::sleep_for(std::chrono::microseconds(100 * (1 + (7 - *in % 7))));
+        --nactive;
+        out = std::make_shared<int>(*in);
+        return true;
+    }
+};
+
+class TwoFanout : public IFanoutNode<int, int, 2> {
+   public:
+    virtual ~TwoFanout() {}
+    virtual std::string signature() { return typeid(TwoFanout).name(); }
+    virtual int concurrency() { return 0; }
+    virtual std::vector<std::string> output_types()
+    {
+        return std::vector<std::string>(2, typeid(int).name());
+    }
+    virtual bool operator()(const input_pointer& in, output_vector& outv)
+    {
+        outv.resize(2);
+        outv[0] = outv[1] = in;
+        return true;
+    }
+};
+
+class PairJoin : public IJoinNode<std::tuple<int, int>, int> {
+   public:
+    virtual ~PairJoin() {}
+    virtual std::string signature() { return typeid(PairJoin).name(); }
+    virtual int concurrency() { return 4; }
+    virtual bool operator()(const input_tuple_type& intup, output_pointer& out)
+    {
+        auto a = std::get<0>(intup);
+        auto b = std::get<1>(intup);
+        if (!a or !b) {
+            Assert(!a and !b);
+            out = nullptr;
+            return true;
+        }
+        Assert(*a == *b);
+        out = a;
+        return true;
+    }
+};
+
+class OrderedSink : public ISinkNode<int> {
+   public:
+    std::vector<int> got;
+    bool eos{false};
+    virtual ~OrderedSink() {}
+    virtual bool operator()(const input_pointer& in)
+    {
+        if (!in) {
+            eos = true;
+            return true;
+        }
+        got.push_back(*in);
+        return true;
+    }
+};
+
+static void connect(Node sender, Node receiver, size_t sport = 0, size_t rport = 0)
+{
+    auto sports = sender->sender_ports();
+    auto rports = receiver->receiver_ports();
+    Assert(sports.size() > sport);
+    Assert(rports.size() > rport);
+    make_edge(*sports[sport], *rports[rport]);
+}
+
+static void run()
+{
+    auto src = std::make_shared<CountSource>();
+    auto fan = std::make_shared<TwoFanout>();
+    auto slow1 = std::make_shared<SlowFunction>(4);
+    auto slow2 = std::make_shared<SlowFunction>(0);
+    auto join = std::make_shared<PairJoin>();
+    auto serial = std::make_shared<SlowFunction>(1);
+    auto sink = std::make_shared<OrderedSink>();
+
+    tbb::flow::graph graph;
+    Node nsrc(new SourceNodeWrapper(graph, src));
+    Node nfan(new FanoutWrapper(graph, fan));
+    Node nslow1(new FunctionWrapper(graph, slow1));
+    Node nslow2(new FunctionWrapper(graph, slow2));
+    Node njoin(new JoinWrapper(graph, join));
+    Node nserial(new FunctionWrapper(graph, serial));
+    Node nsink(new SinkNodeWrapper(graph, sink));
+
+    NodeProfile prof;
+    nslow1->profile(prof, "slow1");
+    nsink->profile(prof, "sink");
+
+    connect(nsrc, nfan);
+    connect(nfan, nslow1, 0);
+    connect(nfan, nslow2, 1);
+    connect(nslow1, njoin, 0, 0);
+    connect(nslow2, njoin, 0, 1);
+    connect(njoin, nserial);
+    connect(nserial, nsink);
+
+    nsrc->initialize();
+    graph.wait_for_all();
+
+    std::cerr << nslow1->info() << "\n"
+              << nslow2->info() << "\n"
+              << "max concurrent calls: " << slow1->maxactive << " " << slow2->maxactive << " "
+              << serial->maxactive << "\n";
+
+    Assert(sink->eos);
+    Assert(sink->got.size() == (size_t) nobjects);
+    for (int ind = 0; ind < nobjects; ++ind) {
+        Assert(sink->got[ind] == ind);
+    }
+    // Peak number of calls in flight at once.
+    Assert(slow1->maxactive > 1 and slow1->maxactive <= 4);
+    Assert(slow2->maxactive > 1);
+    Assert(serial->maxactive == 1);
+    Assert(nslow1->info().calls() == (size_t) nobjects + 1);
+
+    // EOS is also a call.
+    auto calls = prof.calls();
+    Assert(calls.size() == 2 * (nobjects + 1));
+    size_t maxactive = 0;
+    for (const auto& call : calls) {
+        if (call.node == 0) {
+            maxactive = std::max(maxactive, call.queued);
+        }
+        else {
+            Assert(call.nin == 1 and call.nout == 0);
+        }
+    }
+    Assert(maxactive <= 4);
+}
+
+int main()
+{
+    // Use an explicit arena so that concurrency is exercised even on
+    // hosts with few cores.
+    const int nthreads = 8;
+    tbb::global_control gc(tbb::global_control::max_allowed_parallelism, nthreads);
+    tbb::task_arena arena(nthreads);
+    arena.execute(run);
+    return 0;
+}
@@ -27,12 +27,24 @@ namespace WireCell {
             LinearModel::SetX(X);
             SetLambdaWeight(Eigen::VectorXd::Zero(X.cols()) + Eigen::VectorXd::Constant(X.cols(), 1.));
         }
+        void SetSparseX(Eigen::SparseMatrix<double> X)
+        {
+            LinearModel::SetSparseX(X);
+            SetLambdaWeight(Eigen::VectorXd::Constant(X.cols(), 1.));
+        }
         // Perform the fit and return indices of variables below threshold.
         // These can be ignored or the fit may be retried with these variables removed.
         virtual std::vector<size_t> Fit();
 
        protected:
         double _soft_thresholding(double x, double lambda_);
+
+        // Coordinate descent setting each beta(j) in turn to
+        //   S(X_j.r_j / |X_j|^2, l1 * w_j) / (1 + l2)
+        // where r_j is the residual without variable j, starting from
+        // beta if it has been set.  Only the residual is kept up to
+        // date so an update costs the number of nonzeros in X_j.
+        std::vector<size_t> _fit(const Eigen::SparseMatrix<double>& X, double l1, double l2);
         std::vector<bool> _active_beta;
     };
 
@@ -2,6 +2,7 @@
 #define WIRECELLUTIL_LINEARMODEL_H
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@ namespace WireCell {
 
         Eigen::VectorXd& Gety() { return _y; }
         Eigen::MatrixXd& GetX() { return _X; }
+        Eigen::SparseMatrix<double>& GetSparseX() { return _Xs; }
         Eigen::VectorXd& Getbeta() { return _beta; }
 
         virtual void SetData(Eigen::MatrixXd X, Eigen::VectorXd y)
@@ -25,8 +27,23 @@ namespace WireCell {
         virtual void SetX(Eigen::MatrixXd X)
         {
             _X = X;
+            _Xs.resize(0, 0);
             _beta = Eigen::VectorXd::Zero(X.cols());
         }
+
+        // Give X as a sparse matrix.  This replaces any dense X.
+        void SetSparseData(Eigen::SparseMatrix<double> X, Eigen::VectorXd y)
+        {
+            SetSparseX(X);
+            Sety(y);
+        }
+        virtual void SetSparseX(Eigen::SparseMatrix<double> X)
+        {
+            _Xs = X;
+            _X.resize(0, 0);
+            _beta = Eigen::VectorXd::Zero(X.cols());
+        }
+        bool IsSparse() const { return _Xs.cols() > 0; }
         virtual void Setbeta(Eigen::VectorXd beta) { _beta = beta; }
 
         virtual std::vector<size_t> Fit(){ return std::vector<size_t>(); };
@@ -40,6 +57,7 @@ namespace WireCell {
         // convention: lowercase: vector, uppercase matrix.
         Eigen::VectorXd _y;
         Eigen::MatrixXd _X;
+        Eigen::SparseMatrix<double> _Xs;  // used instead of _X if set
         Eigen::VectorXd _beta;
     };
 
@@ -0,0 +1,81 @@
+/** Per-call profiling of data flow graph nodes.
+
+    A NodeProfile collects one record for each call of each node of a
+    DFP graph as executed by any engine (Pgraph or TBB).  A record
+    holds the wall-clock start and stop of the call, the thread that
+    made it, the input queue depth seen at the start of the call and
+    the number of objects consumed and produced.  Optionally, the
+    resident memory is sampled at the end of each call.
+
+    The records may be exported as Chrome / Perfetto trace event JSON
+    which may be loaded by chrome://tracing or https://ui.perfetto.dev
+    to find the nodes on the critical path of a job.
+
+    All methods may be called from concurrent threads.
+ */
+
+#ifndef WIRECELLUTIL_NODEPROFILE
+#define WIRECELLUTIL_NODEPROFILE
+
+#include "WireCellUtil/Configuration.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WireCell {
+
+    class NodeProfile {
+       public:
+        using clock_t = std::chrono::steady_clock;
+        using time_point_t = clock_t::time_point;
+
+        struct Call {
+            size_t node;                // index from add_node()
+            size_t thread;              // index of the calling thread
+            time_point_t start, stop;
+            size_t queued;              // input queue depth at start
+            size_t nin, nout;           // objects consumed and produced
+            double rss;                 // resident memory (kB) at stop, if sampled
+        };
+
+        /// If memory is true, sample resident memory after each call.
+        NodeProfile(bool memory = false);
+
+        /// Register a node by name and return its index.
+        size_t add_node(const std::string& name);
+
+        /// Record one call of the node with the given index.
+        void record(size_t node, time_point_t start, time_point_t stop,
+                    size_t queued = 0, size_t nin = 0, size_t nout = 0);
+
+        /// Discard all calls, keeping registered nodes.
+        void clear();
+
+        /// Return copies of the node names and the calls recorded so far.
+        std::vector<std::string> nodes() const;
+        std::vector<Call> calls() const;
+
+        /// Return the calls as a Chrome trace event JSON object.
+        /// Each call is a complete ("X") event and queue depth (and
+        /// memory, if sampled) are counter ("C") events.
+        Json::Value trace() const;
+
+        /// Write trace() to a file, see Persist::dump() for formats.
+        void dump(const std::string& filename) const;
+
+       private:
+        bool m_memory;
+        time_point_t m_origin;
+        std::vector<std::string> m_nodes;
+        std::vector<Call> m_calls;
+        std::map<std::thread::id, size_t> m_threads;
+        mutable std::mutex m_mutex;
+    };
+
+}  // namespace WireCell
+
+#endif
@@ -0,0 +1,26 @@
+/** Run independent jobs over a few threads.
+
+    This is for components which split one call into a small number
+    of independent jobs (planes, regions, channel groups) and merge
+    their results in job order afterward so that output does not
+    depend on scheduling.
+ */
+
+#ifndef WIRECELLUTIL_PARALLEL
+#define WIRECELLUTIL_PARALLEL
+
+#include <cstddef>
+#include <functional>
+
+namespace WireCell {
+
+    /// Call job(ind) once for each ind in [0, njobs).  Jobs are taken
+    /// in order by up to nthreads threads.  With nthreads less than
+    /// two, or one job, all are called in order in the calling
+    /// thread.  The first exception thrown by a job stops any jobs
+    /// not yet started and is rethrown once all threads finish.
+    void parallel_for(size_t njobs, const std::function<void(size_t)>& job, int nthreads);
+
+}  // namespace WireCell
+
+#endif
@@ -18,6 +18,7 @@
 #define WIRECELL_RESS_HEADER_SEEN
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 
 namespace WireCell {
 
@@ -25,6 +26,7 @@ namespace WireCell {
 
         typedef Eigen::VectorXd vector_t;
         typedef Eigen::MatrixXd matrix_t;
+        typedef Eigen::SparseMatrix<double> sparse_matrix_t;
 
         enum Model {
             unknown = 0,
@@ -55,6 +57,11 @@ namespace WireCell {
             // optional initial measurement weights
             vector_t weights = Eigen::VectorXd());
 
+        // As above but for a sparse response matrix.  The solving
+        // only visits the nonzero elements.
+        vector_t solve(const sparse_matrix_t& response, vector_t measured, const Params& params = Params(),
+                       vector_t source = Eigen::VectorXd(), vector_t weights = Eigen::VectorXd());
+
         // These function provide values derived from a solution
         // ("solved"/"source") and the input response and measured
         // vectors.
@@ -64,6 +71,10 @@ namespace WireCell {
         {
             return response * source;
         }
+        inline vector_t predict(const sparse_matrix_t& response, vector_t source)
+        {
+            return response * source;
+        }
 
         // Return the unbiased part of the chi2.
         inline double chi2_base(vector_t measured, vector_t predicted)
@@ -1,6 +1,7 @@
 #include "WireCellUtil/ElasticNetModel.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 using namespace Eigen;
 
 #include <iostream>
@@ -27,29 +28,33 @@ WireCell::ElasticNetModel::ElasticNetModel(double lambda, double alpha, int max_
 WireCell::ElasticNetModel::~ElasticNetModel() {}
 
 std::vector<size_t> WireCell::ElasticNetModel::Fit()
+{
+    if (IsSparse()) {
+        return _fit(_Xs, lambda * alpha, lambda * (1 - alpha));
+    }
+    return _fit(_X.sparseView(), lambda * alpha, lambda * (1 - alpha));
+}
+
+std::vector<size_t> WireCell::ElasticNetModel::_fit(const SparseMatrix<double>& X, double l1, double l2)
 {
     std::vector<size_t> below_threshold;
 
     // initialize solution to zero unless user set beta already
+    const int nbeta = X.cols();
     Eigen::VectorXd beta = _beta;
-    if (0 == beta.size()) {
-        beta = VectorXd::Zero(_X.cols());
+    if (beta.size() != nbeta) {
+        beta = VectorXd::Zero(nbeta);
     }
 
-    // initialize active_beta to true
-    int nbeta = beta.size();
-    _active_beta = vector<bool>(nbeta, true);
-
     // use alias for easy notation
-    Eigen::VectorXd y = Gety();
-    Eigen::MatrixXd X = GetX();
+    const Eigen::VectorXd& y = Gety();
 
     // cooridate decsent
 
-    // int N = y.size();
-    VectorXd norm(nbeta);
+    // |X_j|^2 and what each update is scaled by
+    VectorXd xnorm(nbeta), norm(nbeta);
     for (int j = 0; j < nbeta; j++) {
-        norm(j) = X.col(j).squaredNorm();
+        xnorm(j) = norm(j) = X.col(j).squaredNorm();
         if (norm(j) < 1e-6) {
             // cerr << "warning: the " << j << "th variable is not used, please consider removing it." << endl;
             below_threshold.push_back(j);
@@ -58,42 +63,58 @@ std::vector<size_t> WireCell::ElasticNetModel::Fit()
     }
     double tol2 = TOL * TOL * nbeta;
 
+    // Iterate over the active variables, all of them at first and
+    // again after convergence to check the active ones are not missing
+    // any.  The residual is remade then so rounding does not build up.
+    std::vector<int> active(nbeta);
+    _active_beta = vector<bool>(nbeta, true);
+    auto activate_all = [&]() {
+        active.resize(nbeta);
+        for (int j = 0; j < nbeta; j++) {
+            active[j] = j;
+            _active_beta[j] = true;
+        }
+    };
+    activate_all();
+    VectorXd resid = y - X * beta;
+
     int double_check = 0;
     for (int i = 0; i < max_iter; i++) {
         VectorXd betalast = beta;
-        for (int j = 0; j < nbeta; j++) {
-            if (!_active_beta[j]) {
-                continue;
+        size_t nactive = 0;
+        for (int j : active) {
+            // X_j.r_j = X_j.r + |X_j|^2 beta(j)
+            double delta_j = xnorm(j) * beta(j);
+            for (SparseMatrix<double>::InnerIterator it(X, j); it; ++it) {
+                delta_j += it.value() * resid(it.row());
+            }
+            const double beta_j = _soft_thresholding(delta_j / norm(j), l1 * lambda_weight(j)) / (1 + l2);
+
+            const double step = beta_j - beta(j);
+            if (step != 0) {
+                for (SparseMatrix<double>::InnerIterator it(X, j); it; ++it) {
+                    resid(it.row()) -= it.value() * step;
+                }
+                beta(j) = beta_j;
             }
-            VectorXd X_j = X.col(j);
-            VectorXd beta_tmp = beta;
-            beta_tmp(j) = 0;
-            VectorXd r_j = (y - X * beta_tmp);
-            double delta_j = X_j.dot(r_j);
-            //            beta(j) = _soft_thresholding(delta_j, N*lambda*alpha*lambda_weight(j)) / (1+lambda*(1-alpha))
-            //            / norm(j);
-            beta(j) =
-                _soft_thresholding(delta_j / norm(j), lambda * alpha * lambda_weight(j)) / (1 + lambda * (1 - alpha));
-
-            // cout << i << " " << j << " " << beta(j) << std::endl;
-            if (fabs(beta(j)) < 1e-6) {
+
+            if (fabs(beta_j) < 1e-6) {
                 _active_beta[j] = false;
             }
-            // else { cout << beta(j) << endl;}
-            // beta(j) = _soft_thresholding(delta_j, N*lambda*alpha, j) / (1+lambda*(1-alpha)) / norm(j);
-            // if (j==0) cout << beta(j) << ", " << arg1 << endl;
+            else {
+                active[nactive++] = j;
+            }
         }
+        active.resize(nactive);
         double_check++;
-        // cout << endl;
         VectorXd diff = beta - betalast;
 
         // std::cout << i << " " << diff.squaredNorm() << " " << tol2 << std::endl;
         if (diff.squaredNorm() < tol2) {
             if (double_check != 1) {
                 double_check = 0;
-                for (int k = 0; k < nbeta; k++) {
-                    _active_beta[k] = true;
-                }
+                activate_all();
+                resid = y - X * beta;
             }
             else {
                 //                cout << "found minimum at iteration: " << i << endl;
@@ -7,7 +7,13 @@ WireCell::LinearModel::LinearModel() {}
 
 WireCell::LinearModel::~LinearModel() {}
 
-VectorXd WireCell::LinearModel::Predict() { return _X * _beta; }
+VectorXd WireCell::LinearModel::Predict()
+{
+    if (IsSparse()) {
+        return _Xs * _beta;
+    }
+    return _X * _beta;
+}
 
 double WireCell::LinearModel::chi2_base() { return (_y - Predict()).squaredNorm(); }
 
@@ -0,0 +1,116 @@
+#include "WireCellUtil/NodeProfile.h"
+#include "WireCellUtil/MemUsage.h"
+#include "WireCellUtil/Persist.h"
+
+using namespace WireCell;
+
+NodeProfile::NodeProfile(bool memory)
+  : m_memory(memory)
+  , m_origin(clock_t::now())
+{
+}
+
+size_t NodeProfile::add_node(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nodes.push_back(name);
+    return m_nodes.size() - 1;
+}
+
+void NodeProfile::record(size_t node, time_point_t start, time_point_t stop,
+                         size_t queued, size_t nin, size_t nout)
+{
+    const double rss = m_memory ? memusage_resident() : -1;
+    const auto tid = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_threads.find(tid);
+    if (it == m_threads.end()) {
+        it = m_threads.emplace(tid, m_threads.size()).first;
+    }
+    m_calls.push_back({node, it->second, start, stop, queued, nin, nout, rss});
+}
+
+void NodeProfile::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calls.clear();
+}
+
+std::vector<std::string> NodeProfile::nodes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nodes;
+}
+
+std::vector<NodeProfile::Call> NodeProfile::calls() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_calls;
+}
+
+Json::Value NodeProfile::trace() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Trace event times are in microseconds.
+    auto usec = [&](time_point_t t) {
+        return std::chrono::duration<double, std::micro>(t - m_origin).count();
+    };
+
+    Json::Value events = Json::arrayValue;
+    for (const auto& it : m_threads) {
+        Json::Value meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = 0;
+        meta["tid"] = (Json::UInt64) it.second;
+        meta["args"]["name"] = "thread " + std::to_string(it.second);
+        events.append(meta);
+    }
+
+    for (const auto& call : m_calls) {
+        const std::string& name = m_nodes.at(call.node);
+
+        Json::Value ev;
+        ev["name"] = name;
+        ev["cat"] = "node";
+        ev["ph"] = "X";
+        ev["pid"] = 0;
+        ev["tid"] = (Json::UInt64) call.thread;
+        ev["ts"] = usec(call.start);
+        ev["dur"] = usec(call.stop) - usec(call.start);
+        ev["args"]["queued"] = (Json::UInt64) call.queued;
+        ev["args"]["nin"] = (Json::UInt64) call.nin;
+        ev["args"]["nout"] = (Json::UInt64) call.nout;
+        events.append(ev);
+
+        Json::Value qd;
+        qd["name"] = "queued " + name;
+        qd["ph"] = "C";
+        qd["pid"] = 0;
+        qd["ts"] = ev["ts"];
+        qd["args"]["queued"] = (Json::UInt64) call.queued;
+        events.append(qd);
+
+        if (call.rss >= 0) {
+            Json::Value mem;
+            mem["name"] = "memory";
+            mem["ph"] = "C";
+            mem["pid"] = 0;
+            mem["ts"] = usec(call.stop);
+            mem["args"]["rss_kB"] = call.rss;
+            events.append(mem);
+        }
+    }
+
+    Json::Value top;
+    top["traceEvents"] = events;
+    top["displayTimeUnit"] = "ms";
+    return top;
+}
+
+void NodeProfile::dump(const std::string& filename) const
+{
+    Persist::dump(filename, trace());
+}
@@ -0,0 +1,47 @@
+#include "WireCellUtil/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void WireCell::parallel_for(size_t njobs, const std::function<void(size_t)>& job, int nthreads)
+{
+    const size_t nworkers = std::min((size_t) std::max(nthreads, 1), njobs);
+    if (nworkers <= 1) {
+        for (size_t ind = 0; ind < njobs; ++ind) {
+            job(ind);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+    auto worker = [&]() {
+        for (size_t ind = next++; ind < njobs; ind = next++) {
+            try {
+                job(ind);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = njobs;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t ind = 0; ind < nworkers; ++ind) {
+        workers.emplace_back(worker);
+    }
+    for (auto& one : workers) {
+        one.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
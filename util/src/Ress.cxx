@@ -2,42 +2,62 @@
 
 #include "WireCellUtil/LassoModel.h"
 
+#include <type_traits>
+
 using namespace WireCell;
 
-Ress::vector_t Ress::solve(Ress::matrix_t matrix, Ress::vector_t measured, const Ress::Params& params,
-                           Ress::vector_t initial, Ress::vector_t weights)
+// Set the data and solve.  The initial source is set after the data
+// as setting the data resets the solution.
+template <typename Matrix>
+static Ress::vector_t solve_model(ElasticNetModel& model, const Matrix& matrix, const Ress::vector_t& measured,
+                                  const Ress::Params& params, const Ress::vector_t& initial,
+                                  const Ress::vector_t& weights)
+{
+    if constexpr (std::is_same_v<Matrix, Ress::sparse_matrix_t>) {
+        model.SetSparseData(matrix, measured);
+    }
+    else {
+        model.SetData(matrix, measured);
+    }
+    if (params.set_init) {
+        model.Setbeta(initial);
+    }
+    if (weights.size()) {
+        model.SetLambdaWeight(weights);
+    }
+    model.Fit();
+    return model.Getbeta();
+}
+
+template <typename Matrix>
+static Ress::vector_t solve_any(const Matrix& matrix, const Ress::vector_t& measured, const Ress::Params& params,
+                                const Ress::vector_t& initial, const Ress::vector_t& weights)
 {
     // Provide a uniform interface to RESS solving models.  RESS
     // *almost* already provides this.
 
     if (params.model == Ress::lasso) {
         WireCell::LassoModel model(params.lambda, params.max_iter, params.tolerance, params.non_negative);
-        if (params.set_init) {
-	  model.Setbeta(initial);
-	}
-        // FIXME: SetData overwrites SetLambdaWeight
-        model.SetData(matrix, measured);
-        if (weights.size()) {
-            model.SetLambdaWeight(weights);
-        }
-        model.Fit();
-        return model.Getbeta();
+        return solve_model(model, matrix, measured, params, initial, weights);
     }
 
     if (params.model == Ress::elnet) {
         WireCell::ElasticNetModel model(params.lambda, params.alpha, params.max_iter, params.tolerance,
                                         params.non_negative);
-	if (params.set_init) {
-	  model.Setbeta(initial);
-        }
-        model.SetData(matrix, measured);
-	if (weights.size()) {
-            model.SetLambdaWeight(weights);
-        }
-        model.Fit();
-        return model.Getbeta();
+        return solve_model(model, matrix, measured, params, initial, weights);
     }
 
     return Ress::vector_t();
 }
 
+Ress::vector_t Ress::solve(Ress::matrix_t matrix, Ress::vector_t measured, const Ress::Params& params,
+                           Ress::vector_t initial, Ress::vector_t weights)
+{
+    return solve_any(matrix, measured, params, initial, weights);
+}
+
+Ress::vector_t Ress::solve(const Ress::sparse_matrix_t& matrix, Ress::vector_t measured, const Ress::Params& params,
+                           Ress::vector_t initial, Ress::vector_t weights)
+{
+    return solve_any(matrix, measured, params, initial, weights);
+}
@@ -0,0 +1,67 @@
+#include "WireCellUtil/NodeProfile.h"
+#include "WireCellUtil/Testing.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+
+int main(int argc, char* argv[])
+{
+    NodeProfile prof(true);
+    const size_t a = prof.add_node("a");
+    const size_t b = prof.add_node("b");
+    Assert(a == 0 and b == 1);
+
+    auto work = [&](size_t node, size_t ncalls) {
+        for (size_t ind = 0; ind < ncalls; ++ind) {
+            auto t0 = NodeProfile::clock_t::now();
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            prof.record(node, t0, NodeProfile::clock_t::now(), ind, 1, 2);
+        }
+    };
+    std::thread ta(work, a, 10), tb(work, b, 20);
+    ta.join();
+    tb.join();
+
+    auto calls = prof.calls();
+    Assert(calls.size() == 30);
+    size_t nb = 0;
+    for (const auto& call : calls) {
+        Assert(call.stop >= call.start);
+        Assert(call.rss > 0);
+        Assert(call.nin == 1 and call.nout == 2);
+        if (call.node == b) {
+            ++nb;
+        }
+    }
+    Assert(nb == 20);
+
+    auto top = prof.trace();
+    const auto& events = top["traceEvents"];
+    size_t nmeta = 0, ncomplete = 0, ncounter = 0;
+    for (const auto& ev : events) {
+        const std::string ph = ev["ph"].asString();
+        if (ph == "M") ++nmeta;
+        if (ph == "X") {
+            ++ncomplete;
+            Assert(ev["dur"].asDouble() >= 10);
+            Assert(ev["tid"].asUInt64() < 2);
+        }
+        if (ph == "C") ++ncounter;
+    }
+    std::cerr << nmeta << " threads, " << ncomplete << " calls, " << ncounter << " counters\n";
+    Assert(nmeta == 2);
+    Assert(ncomplete == 30);
+    Assert(ncounter == 60);  // queue depth and memory
+
+    if (argc > 1) {
+        prof.dump(argv[1]);
+    }
+
+    prof.clear();
+    Assert(prof.calls().empty());
+    Assert(prof.nodes().size() == 2);
+    return 0;
+}
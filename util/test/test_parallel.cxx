@@ -0,0 +1,41 @@
+// Check WireCell::parallel_for runs every job once and passes on a
+// job's exception.
+#include "WireCellUtil/Parallel.h"
+#include "WireCellUtil/Exceptions.h"
+#include "WireCellUtil/Testing.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace WireCell;
+
+int main()
+{
+    for (int nthreads : {0, 1, 3, 8}) {
+        const size_t njobs = 100;
+        std::vector<int> calls(njobs, 0);
+        parallel_for(njobs, [&](size_t ind) { ++calls[ind]; }, nthreads);
+        for (int one : calls) {
+            Assert(one == 1);
+        }
+
+        parallel_for(0, [&](size_t ind) { Assert(false); }, nthreads);
+
+        std::atomic<int> ncalled{0};
+        bool caught = false;
+        try {
+            parallel_for(njobs, [&](size_t ind) {
+                ++ncalled;
+                if (ind == 10) {
+                    raise<ValueError>("job %d fails", ind);
+                }
+            }, nthreads);
+        }
+        catch (const ValueError&) {
+            caught = true;
+        }
+        Assert(caught);
+        Assert(ncalled >= 11 and ncalled <= (int) njobs);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Check that Lasso and elastic net fits give the same solution with a
+// dense or a sparse response and that Ress::solve honors set_init.
+#include "WireCellUtil/Ress.h"
+#include "WireCellUtil/LassoModel.h"
+#include "WireCellUtil/Testing.h"
+
+#include <iostream>
+#include <random>
+
+using namespace WireCell;
+
+int main()
+{
+    // A blob-measure like incidence: each blob is seen by a few measures.
+    const int nblobs = 300, nmeas = 200;
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> pick(0, nmeas - 1);
+    std::uniform_real_distribution<double> uni(0, 1);
+
+    Ress::matrix_t dense = Ress::matrix_t::Zero(nmeas, nblobs);
+    Ress::vector_t truth(nblobs);
+    for (int ib = 0; ib < nblobs; ++ib) {
+        for (int ip = 0; ip < 3; ++ip) {
+            dense(pick(rng), ib) = 1;
+        }
+        truth(ib) = uni(rng) < 0.3 ? 0 : 100 + 50 * uni(rng);
+    }
+    const Ress::sparse_matrix_t sparse = dense.sparseView();
+    const Ress::vector_t measured = dense * truth;
+
+    for (auto model : {Ress::lasso, Ress::elnet}) {
+        Ress::Params params;
+        params.model = model;
+        params.lambda = 0.01;
+        params.alpha = model == Ress::lasso ? 1.0 : 0.9;
+
+        const auto dsol = Ress::solve(dense, measured, params);
+        const auto ssol = Ress::solve(sparse, measured, params);
+        Assert(dsol.size() == nblobs and ssol.size() == nblobs);
+        const double diff = (dsol - ssol).norm();
+        std::cerr << "model " << model << " |dense - sparse| = " << diff << "\n";
+        Assert(diff < 1e-9 * dsol.norm());
+        Assert((Ress::predict(sparse, ssol) - Ress::predict(dense, dsol)).norm() < 1e-6 * measured.norm());
+
+        // Starting from the solution, it is kept.
+        params.set_init = true;
+        const auto wsol = Ress::solve(sparse, measured, params, ssol);
+        Assert((wsol - ssol).norm() < 1e-3 * ssol.norm());
+    }
+
+    // Variables no measure sees are reported.
+    Ress::sparse_matrix_t unseen = sparse;
+    unseen.col(0) *= 0;
+    LassoModel lasso(0.01);
+    lasso.SetSparseData(unseen, measured);
+    auto below = lasso.Fit();
+    Assert(below.size() == 1 and below[0] == 0);
+    Assert(lasso.Getbeta()(0) == 0);
+
+    return 0;
+}